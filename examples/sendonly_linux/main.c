@@ -4,10 +4,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
 
 #define TX_MSG_MAX_SIZE        3
 #define TX_MSG_MAX_ESCAPE_SIZE 3
 #define TX_MAX_BUF_SIZE        RDLC_GET_FRAME_SIZE(TX_MSG_MAX_SIZE,TX_MSG_MAX_ESCAPE_SIZE)
+#define RX_BUF_SIZE            (TX_MSG_MAX_SIZE + 6)
+#define TX_BATCH_BUF_SIZE      512
+#define TX_BATCH_MAX_FRAMES    64
+#define TX_BATCH_FLUSH_MS      50
 #define SRC_PORT               0x01
 #define DST_PORT               0x02
 
@@ -25,6 +30,21 @@ int onError(Rdlc_t handle, int err) {
     return 0;
 }
 
+// ========== 批量发送：一批帧只调用一次write() ==========
+static int serialFd = -1;
+
+int onBatchFlush(Rdlc_t handle, const uint8_t *data, uint16_t size, const uint16_t *offsets, uint16_t count) {
+    write(serialFd, data, size);
+    printf("[SEND] %u frames, %u bytes in one write().\n", count, size);
+    return 0;
+}
+
+static uint32_t nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
 // ========== 日志接口 ==========
 int portPrintf(RdlcLogLevel_t level, const char *fmt, va_list args) {
     vprintf(fmt, args);
@@ -46,6 +66,7 @@ int main(int argc, char *argv[]) {
         perror("open_serial");
         return 1;
     }
+    serialFd = fd;
 
     static RdlcStaticHandle_t handle;
     static uint8_t rxBuf[RX_BUF_SIZE];
@@ -69,20 +90,32 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    uint8_t readBuf[64];
-    uint8_t frameBuf[TX_BUF_SIZE];
+    static uint8_t batchBuf[TX_BATCH_BUF_SIZE];
+    static uint16_t batchOffsets[TX_BATCH_MAX_FRAMES];
+    RdlcBatchConfig_t batchConfig = {
+        .buffer = batchBuf,
+        .bufferSize = sizeof(batchBuf),
+        .offsets = batchOffsets,
+        .offsetsMax = TX_BATCH_MAX_FRAMES,
+        .flushSize = 0,
+        .flushTicks = TX_BATCH_FLUSH_MS,
+        .cbFlush = onBatchFlush
+    };
+    RdlcBatch_t batch;
+    if (xRdlcBatchInit(proto, &batch, &batchConfig) != RDLC_OK) {
+        fprintf(stderr, "Failed to create RDLC batch\n");
+        return 1;
+    }
 
     printf("[INFO] Listening on %s @ %d baud...\n", serial_device, baudrate);
 
     while (1) {
         uint8_t testPayload[] = {0x11, 0x22, 0x33};
         RdlcAddr_t addr = {.srcAddr = SRC_PORT, .dstAddr = DST_PORT};
-        int len = xRdlcWriteBytes(proto, addr, testPayload, sizeof(testPayload), frameBuf, sizeof(frameBuf));
-        if (len > 0) {
-            write(fd, frameBuf, len);
-            printf("[SEND] %d bytes sent.\n", len);
-        }
+        // 每10ms封包一帧，攒满50ms再一次性发送
+        xRdlcBatchAppend(&batch, addr, testPayload, sizeof(testPayload), nowMs());
         usleep(10000);
+        xRdlcBatchPoll(&batch, nowMs());
     }
 
     vRdlcDestroy(proto);
@@ -0,0 +1,137 @@
+#include "rdlc.h"
+#include "rdlc_linux.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#define MSG_MAX_SIZE        256
+#define MSG_MAX_ESCAPE_SIZE 256
+#define TX_QUEUE_SIZE       (16 * RDLC_GET_FRAME_SIZE(MSG_MAX_SIZE,MSG_MAX_ESCAPE_SIZE))
+#define MAX_LINKS           32
+#define HEARTBEAT_MS        1000
+#define LOCAL_ADDR          0x01
+
+// ========== 每个串口一条链路 ==========
+typedef struct {
+    const char *dev;
+    int fd;
+    Rdlc_t proto;
+    RdlcLinuxLink_t link;
+    uint8_t txQueue[TX_QUEUE_SIZE];
+} Port_t;
+
+static Port_t ports[MAX_LINKS];
+static int portCount = 0;
+static RdlcLinuxLoop_t loop;
+
+static Port_t *findPort(Rdlc_t handle) {
+    for (int i = 0; i < portCount; i++)
+        if (ports[i].proto == handle)
+            return &ports[i];
+    return NULL;
+}
+
+// ========== 回调函数 ==========
+// 收到的帧原样回送给发送方
+int onParsed(Rdlc_t handle, RdlcAddr_t addr, const uint8_t *payload, uint16_t len) {
+    Port_t *port = findPort(handle);
+    printf("[RECV] %s: %02X -> %02X | Len: %u\n", port->dev, addr.srcAddr, addr.dstAddr, len);
+    RdlcAddr_t reply = {.srcAddr = addr.dstAddr, .dstAddr = addr.srcAddr};
+    if (xRdlcLinuxSend(&loop, &port->link, reply, payload, len) != RDLC_OK)
+        fprintf(stderr, "[WARN] %s: tx queue full, reply dropped\n", port->dev);
+    return 0;
+}
+
+int onError(Rdlc_t handle, int err) {
+    fprintf(stderr, "[ERROR] Code: %d\n", err);
+    return 0;
+}
+
+int onClosed(Rdlc_t handle, RdlcLinuxLink_t *link, int err) {
+    Port_t *port = findPort(handle);
+    fprintf(stderr, "[CLOSE] %s: %s\n", port->dev, err ? strerror(err) : "hang up");
+    return 0;
+}
+
+static uint32_t nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// ========== 主程序 ==========
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <baudrate> <serial_device>...\n", argv[0]);
+        return 1;
+    }
+
+    int baudrate = atoi(argv[1]);
+    static uint8_t rxBuf[RDLC_LINUX_RX_BUF_SIZE];
+    if (xRdlcLinuxLoopInit(&loop, rxBuf, sizeof(rxBuf)) != RDLC_OK) {
+        perror("epoll");
+        return 1;
+    }
+
+    RdlcConfig_t config = {
+        .msgMaxSize = MSG_MAX_SIZE,
+        .msgMaxEscapeSize = MSG_MAX_ESCAPE_SIZE,
+        .cbParsed = onParsed,
+        .cbError = onError
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL
+    };
+
+    for (int i = 2; i < argc && portCount < MAX_LINKS; i++) {
+        Port_t *p = &ports[portCount];
+        p->dev = argv[i];
+        p->fd = xRdlcLinuxOpenSerial(p->dev, baudrate);
+        if (p->fd < 0) {
+            perror(p->dev);
+            continue;
+        }
+        p->proto = xRdlcCreate(&config, &port);
+        RdlcLinuxLinkConfig_t linkConfig = {
+            .fd = p->fd,
+            .protoHandle = p->proto,
+            .txBuf = p->txQueue,
+            .txBufSize = sizeof(p->txQueue),
+            .cbClosed = onClosed
+        };
+        if (!p->proto || xRdlcLinuxLinkAdd(&loop, &p->link, &linkConfig) != RDLC_OK) {
+            fprintf(stderr, "Failed to add %s\n", p->dev);
+            close(p->fd);
+            continue;
+        }
+        portCount++;
+    }
+    printf("[INFO] Serving %d ports @ %d baud in one thread...\n", portCount, baudrate);
+
+    uint32_t lastHeartbeat = nowMs();
+    uint8_t heartbeat = 0;
+    while (portCount > 0) {
+        xRdlcLinuxLoopRun(&loop, HEARTBEAT_MS);
+        if ((uint32_t)(nowMs() - lastHeartbeat) < HEARTBEAT_MS)
+            continue;
+        lastHeartbeat = nowMs();
+        heartbeat++;
+        for (int i = 0; i < portCount; i++) {
+            RdlcAddr_t addr = {.srcAddr = LOCAL_ADDR, .dstAddr = (uint8_t)(0x10 + i)};
+            if (ports[i].link.state == RDLC_LINUX_LINK_OPEN)
+                xRdlcLinuxSend(&loop, &ports[i].link, addr, &heartbeat, 1);
+        }
+    }
+
+    for (int i = 0; i < portCount; i++) {
+        xRdlcLinuxLinkRemove(&loop, &ports[i].link);
+        vRdlcDestroy(ports[i].proto);
+        close(ports[i].fd);
+    }
+    vRdlcLinuxLoopDeinit(&loop);
+    return 0;
+}
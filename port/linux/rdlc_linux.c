@@ -0,0 +1,360 @@
+/**
+ * @file rdlc_linux.c
+ * @brief RDLC的Linux传输层：一个线程用epoll同时服务多个非阻塞串口，读到的数据整块送入RDLC解包，发送经过队列处理部分写
+ * @author 陈煜楷
+ * @version 1.1@2025-5-16
+**/
+
+#include "rdlc_linux.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+/**
+ *@brief 把波特率数值换成termios的速度常量，不认识的波特率返回B0
+ *@addtogroup 支撑功能
+**/
+static speed_t prvLinuxBaudrate(int baudrate)
+{
+    switch (baudrate) {
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+#ifdef B460800
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+        case 4000000: return B4000000;
+#endif
+        default:      return B0;
+    }
+}
+
+/**
+ *@brief 修改链路关注的事件：总是关注可读，发送队列非空时再关注可写
+ *@addtogroup 支撑功能
+**/
+static int prvLinuxLinkArm(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,uint8_t txArmed)
+{
+    if (link->txArmed == txArmed)
+        return RDLC_OK;
+    struct epoll_event event = {
+        .events = EPOLLIN | (txArmed ? EPOLLOUT : 0),
+        .data.ptr = link,
+    };
+    if (epoll_ctl(loop->epollFd,EPOLL_CTL_MOD,link->config.fd,&event) != 0)
+        return RDLC_ERR_IO;
+    link->txArmed = txArmed;
+    return RDLC_OK;
+}
+
+/**
+ *@brief 关闭链路：从事件循环中移除，丢弃发送队列，通知用户
+ *@addtogroup 支撑功能
+**/
+static void prvLinuxLinkClose(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,int err)
+{
+    if (link->state != RDLC_LINUX_LINK_OPEN)
+        return;
+    epoll_ctl(loop->epollFd,EPOLL_CTL_DEL,link->config.fd,NULL);
+    link->state = RDLC_LINUX_LINK_CLOSED;
+    link->txHead = link->txTail = 0;
+    link->txArmed = 0;
+    if (link->config.cbClosed)
+        link->config.cbClosed(link->config.protoHandle,link,err);
+}
+
+/**
+ *@brief 尽量写出发送队列，写不完时等待EPOLLOUT，写完后不再关注可写
+ *@addtogroup 支撑功能
+**/
+static int prvLinuxLinkFlush(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link)
+{
+    while (link->txHead < link->txTail) {
+        ssize_t n = write(link->config.fd,&link->config.txBuf[link->txHead],link->txTail - link->txHead);
+        link->txSyscalls++;
+        if (n > 0) {
+            link->txHead += n;
+            link->txBytes += n;
+            continue;
+        }
+        if ((n < 0) && (errno == EINTR))
+            continue;
+        if ((n < 0) && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return prvLinuxLinkArm(loop,link,1);
+        prvLinuxLinkClose(loop,link,(n < 0) ? errno : 0);
+        return RDLC_ERR_IO;
+    }
+    link->txHead = link->txTail = 0;
+    return prvLinuxLinkArm(loop,link,0);
+}
+
+/**
+ *@brief 为即将入队的size字节腾出连续空间，必要时把未写完的数据挪到队列开头
+ *@addtogroup 支撑功能
+**/
+static uint8_t *prvLinuxLinkReserve(RdlcLinuxLink_t *link,size_t size)
+{
+    size_t pending = link->txTail - link->txHead;
+    if (size > link->config.txBufSize - pending)
+        return NULL;
+    if (size > link->config.txBufSize - link->txTail) {
+        memmove(link->config.txBuf,&link->config.txBuf[link->txHead],pending);
+        link->txHead = 0;
+        link->txTail = pending;
+    }
+    return &link->config.txBuf[link->txTail];
+}
+
+/**
+ *@brief 新数据入队之后，队列原本为空时立即尝试写出；否则已经在等待EPOLLOUT，由事件循环继续
+ *@addtogroup 支撑功能
+**/
+static int prvLinuxLinkCommit(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,size_t size)
+{
+    link->txTail += size;
+    if (link->txArmed)
+        return RDLC_OK;
+    return prvLinuxLinkFlush(loop,link);
+}
+
+/**
+ *@brief 读空一条链路，每次读到的数据整块送入xRdlcReadBytes，其中某一帧出错时后面的帧照常解析，只计入rxErrors
+ *@addtogroup 支撑功能
+**/
+static void prvLinuxLinkRead(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link)
+{
+    while (link->state == RDLC_LINUX_LINK_OPEN) {
+        ssize_t n = read(link->config.fd,loop->rxBuf,loop->rxBufSize);
+        link->rxSyscalls++;
+        if (n > 0) {
+            link->rxBytes += n;
+            if (xRdlcReadBytes(link->config.protoHandle,loop->rxBuf,(size_t)n) < 0)
+                link->rxErrors++;
+            // 没有读满说明内核中已经没有数据了，省掉一次必然返回EAGAIN的read()；水平触发，漏掉的数据下次还会就绪
+            if ((size_t)n < loop->rxBufSize)
+                return;
+            continue;
+        }
+        if ((n < 0) && (errno == EINTR))
+            continue;
+        if ((n < 0) && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        // 读到EOF(管道写端关闭)或出错，伪终端对端关闭时读返回EIO
+        prvLinuxLinkClose(loop,link,(n < 0 && errno != EIO) ? errno : 0);
+        return;
+    }
+}
+
+/**
+ * @brief 以非阻塞、原始模式打开串口：8N1，无流控，不做任何字符转换
+ *
+ * @param dev 设备路径，如/dev/ttyUSB0
+ * @param baudrate 波特率，如115200
+ * @return int 成功时返回fd，失败时返回错误码，原因见errno
+ */
+int xRdlcLinuxOpenSerial(const char *dev,int baudrate)
+{
+    speed_t speed = prvLinuxBaudrate(baudrate);
+    if (!dev || speed == B0)
+        return RDLC_ERR_INVALID_ARG;
+    int fd = open(dev,O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return RDLC_ERR_IO;
+
+    struct termios tty;
+    if (tcgetattr(fd,&tty) != 0) {
+        close(fd);
+        return RDLC_ERR_IO;
+    }
+    cfmakeraw(&tty);
+    cfsetospeed(&tty,speed);
+    cfsetispeed(&tty,speed);
+    tty.c_cflag |= (CLOCAL | CREAD);
+    tty.c_cflag &= ~(PARENB | PARODD | CSTOPB | CRTSCTS);
+    tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+    // 非阻塞fd上VMIN/VTIME不起作用，何时读由epoll决定
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(fd,TCSANOW,&tty) != 0) {
+        close(fd);
+        return RDLC_ERR_IO;
+    }
+    tcflush(fd,TCIOFLUSH);
+    return fd;
+}
+
+/**
+ * @brief 初始化事件循环
+ *
+ * @param loop 事件循环，由调用者分配
+ * @param rxBuf 所有链路共用的读缓冲区，越大每次read()能带回的数据越多，推荐RDLC_LINUX_RX_BUF_SIZE
+ * @param rxBufSize 读缓冲区大小
+ * @return int 错误状态码
+ */
+int xRdlcLinuxLoopInit(RdlcLinuxLoop_t *loop,uint8_t *rxBuf,size_t rxBufSize)
+{
+    if (!loop || !rxBuf || rxBufSize == 0)
+        return RDLC_ERR_INVALID_ARG;
+    memset(loop,0,sizeof(RdlcLinuxLoop_t));
+    loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epollFd < 0)
+        return RDLC_ERR_IO;
+    loop->rxBuf = rxBuf;
+    loop->rxBufSize = rxBufSize;
+    return RDLC_OK;
+}
+
+/**
+ * @brief 释放事件循环，链路的fd不会被关闭
+ *
+ * @param loop 事件循环
+ */
+void vRdlcLinuxLoopDeinit(RdlcLinuxLoop_t *loop)
+{
+    if (!loop || loop->epollFd < 0)
+        return;
+    close(loop->epollFd);
+    loop->epollFd = -1;
+}
+
+/**
+ * @brief 把一条链路加入事件循环，fd会被设为非阻塞
+ *
+ * @param loop 事件循环
+ * @param link 链路，由调用者分配，移除之前不能释放
+ * @param config 链路配置，会被拷贝
+ * @return int 错误状态码
+ */
+int xRdlcLinuxLinkAdd(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,const RdlcLinuxLinkConfig_t *config)
+{
+    if (!loop || !link || !config || config->fd < 0 || !config->protoHandle || !config->txBuf || config->txBufSize == 0)
+        return RDLC_ERR_INVALID_ARG;
+    int flags = fcntl(config->fd,F_GETFL);
+    if (flags < 0 || fcntl(config->fd,F_SETFL,flags | O_NONBLOCK) != 0)
+        return RDLC_ERR_IO;
+
+    memset(link,0,sizeof(RdlcLinuxLink_t));
+    memcpy(&link->config,config,sizeof(RdlcLinuxLinkConfig_t));
+    struct epoll_event event = {
+        .events = EPOLLIN,
+        .data.ptr = link,
+    };
+    if (epoll_ctl(loop->epollFd,EPOLL_CTL_ADD,config->fd,&event) != 0)
+        return RDLC_ERR_IO;
+    link->state = RDLC_LINUX_LINK_OPEN;
+    return RDLC_OK;
+}
+
+/**
+ * @brief 把链路从事件循环中移除，发送队列中没写完的数据被丢弃，fd由调用者关闭
+ *
+ * @param loop 事件循环
+ * @param link 链路
+ * @return int 错误状态码
+ */
+int xRdlcLinuxLinkRemove(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link)
+{
+    if (!loop || !link)
+        return RDLC_ERR_INVALID_ARG;
+    if (link->state == RDLC_LINUX_LINK_OPEN)
+        epoll_ctl(loop->epollFd,EPOLL_CTL_DEL,link->config.fd,NULL);
+    link->state = RDLC_LINUX_LINK_IDLE;
+    link->txHead = link->txTail = 0;
+    link->txArmed = 0;
+    return RDLC_OK;
+}
+
+/**
+ * @brief 封包一帧并发送。帧直接封包到发送队列中，队列原本为空时立即write()，写不完的部分在fd可写时由事件循环继续
+ *
+ * @param loop 事件循环
+ * @param link 链路
+ * @param addr 目的地址和源地址
+ * @param payload 载荷
+ * @param payloadSize 载荷长度
+ * @return int 错误状态码，发送队列放不下这一帧时返回RDLC_ERR_BUFFER_TOO_SHORT，这一帧不会入队
+ *
+ * @note 返回RDLC_OK只代表帧已入队，不代表已经写入内核
+ */
+int xRdlcLinuxSend(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize)
+{
+    if (!loop || !link || link->state != RDLC_LINUX_LINK_OPEN)
+        return RDLC_ERR_NOT_ALLOWED;
+    int frameSize = xRdlcGetFrameSize(link->config.protoHandle,addr,payload,payloadSize);
+    if (frameSize < 0)
+        return frameSize;
+    uint8_t *frame = prvLinuxLinkReserve(link,(size_t)frameSize);
+    if (frame == NULL)
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    int len = xRdlcWriteBytes(link->config.protoHandle,addr,payload,payloadSize,frame,(size_t)frameSize);
+    if (len < 0)
+        return len;
+    return prvLinuxLinkCommit(loop,link,(size_t)len);
+}
+
+/**
+ * @brief 发送已经封包好的数据，例如批量封包器在cbFlush中交出的一批帧
+ *
+ * @param loop 事件循环
+ * @param link 链路
+ * @param data 数据
+ * @param size 数据长度
+ * @return int 错误状态码，发送队列放不下时返回RDLC_ERR_BUFFER_TOO_SHORT，数据不会入队
+ */
+int xRdlcLinuxSendRaw(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,const uint8_t *data,size_t size)
+{
+    if (!loop || !link || link->state != RDLC_LINUX_LINK_OPEN)
+        return RDLC_ERR_NOT_ALLOWED;
+    if (!data && size)
+        return RDLC_ERR_INVALID_ARG;
+    uint8_t *dst = prvLinuxLinkReserve(link,size);
+    if (dst == NULL)
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    if (size > 0)
+        memcpy(dst,data,size);
+    return prvLinuxLinkCommit(loop,link,size);
+}
+
+/**
+ * @brief 运行一轮事件循环：等待任意链路就绪，读空可读的链路并解包，继续写出可写链路的发送队列
+ *
+ * @param loop 事件循环
+ * @param timeoutMs 最长等待时间，取-1一直等待，取0只检查不等待
+ * @return int 处理的就绪链路数，超时返回0，出错时返回错误码
+ *
+ * @note 解包回调在本函数中执行，回调中可以调用xRdlcLinuxSend
+ */
+int xRdlcLinuxLoopRun(RdlcLinuxLoop_t *loop,int timeoutMs)
+{
+    if (!loop || loop->epollFd < 0)
+        return RDLC_ERR_INVALID_ARG;
+    struct epoll_event events[RDLC_LINUX_MAX_EVENTS];
+    int count = epoll_wait(loop->epollFd,events,RDLC_LINUX_MAX_EVENTS,timeoutMs);
+    loop->waitSyscalls++;
+    if (count < 0)
+        return (errno == EINTR) ? 0 : RDLC_ERR_IO;
+
+    for (int i = 0; i < count; i++) {
+        RdlcLinuxLink_t *link = (RdlcLinuxLink_t *)events[i].data.ptr;
+        // 前一个链路的回调可能移除了这条链路
+        if (link->state != RDLC_LINUX_LINK_OPEN)
+            continue;
+        // 挂断时内核中可能还有没读完的数据，先读再关闭
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            prvLinuxLinkRead(loop,link);
+        if ((events[i].events & EPOLLOUT) && (link->state == RDLC_LINUX_LINK_OPEN))
+            prvLinuxLinkFlush(loop,link);
+        if ((events[i].events & (EPOLLHUP | EPOLLERR)) && (link->state == RDLC_LINUX_LINK_OPEN))
+            prvLinuxLinkClose(loop,link,0);
+    }
+    return count;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file rdlc_linux.h
+ * @brief RDLC的Linux传输层：一个线程用epoll同时服务多个非阻塞串口，读到的数据整块送入RDLC解包，发送经过队列处理部分写
+ * @author 陈煜楷
+ * @version 1.1@2025-5-16
+ *
+ * 每个串口(或伪终端、管道等任意fd)对应一个RdlcLinuxLink_t和一个RDLC实例，所有链路挂在同一个RdlcLinuxLoop_t上。
+ * 除xRdlcLinuxOpenSerial外，所有函数都只能在运行xRdlcLinuxLoopRun的线程中调用，包括RDLC的回调中。
+ * 内核不低于5.19时也可以改用io_uring后端(xRdlcLinuxUring*)：读请求常驻内核(6.7起一次提交可多次完成)，数据直接落在预先注册的缓冲区中，
+ * 发送的帧攒到下一次xRdlcLinuxUringRun一起提交，收发合计每轮只需要一次系统调用。两种后端使用同一种链路。
+**/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "rdlc.h"
+
+/// 链路状态
+#define RDLC_LINUX_LINK_IDLE   0 ///< 未加入事件循环
+#define RDLC_LINUX_LINK_OPEN   1 ///< 正在收发
+#define RDLC_LINUX_LINK_CLOSED 2 ///< 对端挂断或读写出错，已从事件循环中移除，fd仍由调用者关闭
+
+typedef struct RdlcLinuxLink RdlcLinuxLink_t;
+
+/// 链路关闭回调：(句柄,链路,errno，对端挂断时为0)
+typedef int (*RdlcLinuxOnClosed_fptr)(Rdlc_t,RdlcLinuxLink_t*,int);
+
+/// 链路配置类型
+typedef struct{
+    int fd;                          ///< 已打开的fd，加入时会被设为非阻塞
+    Rdlc_t protoHandle;              ///< 解包这条链路的RDLC实例，发送时也用它封包
+    uint8_t *txBuf;                  ///< 发送队列，帧直接封包到这里，写不完的部分等fd可写时继续
+    size_t txBufSize;
+    RdlcLinuxOnClosed_fptr cbClosed; ///< 链路关闭回调，可以为NULL
+}RdlcLinuxLinkConfig_t;
+
+/// 链路定义，由xRdlcLinuxLinkAdd初始化，统计以外的成员不应被用户直接修改
+struct RdlcLinuxLink{
+    RdlcLinuxLinkConfig_t config;
+    size_t txHead;        ///< 队列中下一个待写的字节
+    size_t txTail;        ///< 队列中已有数据的末尾
+    uint8_t state;
+    uint8_t txArmed;      ///< 是否在等待EPOLLOUT
+    void *userData;       ///< 留给用户使用
+    uint64_t rxBytes;     ///< 统计：读到的字节数
+    uint64_t txBytes;     ///< 统计：写出的字节数
+    uint64_t rxSyscalls;  ///< 统计：read()次数
+    uint64_t txSyscalls;  ///< 统计：write()次数
+    uint64_t rxErrors;    ///< 统计：读到的数据中含有出错的帧的次数，出错的帧不影响同一次读到的其他帧
+    size_t txInflight;    ///< io_uring后端：已交给内核还没写完的字节数，这部分数据不能移动
+    uint8_t rxArmed;      ///< io_uring后端：读请求是否还在内核中
+    uint16_t uringOps;    ///< io_uring后端：还没完成的请求数，为0之前链路不能释放
+    uint8_t uringCancel;  ///< io_uring后端：关闭时取消请求是否已交给内核，提交队列满时由xRdlcLinuxUringLinkRemove重试
+};
+
+/// 事件循环定义，由xRdlcLinuxLoopInit初始化，成员不应被用户直接修改
+typedef struct{
+    int epollFd;
+    uint8_t *rxBuf;       ///< 所有链路共用的读缓冲区，一次read()读满后整块送入xRdlcReadBytes
+    size_t rxBufSize;
+    uint64_t waitSyscalls; ///< 统计：epoll_wait()次数
+}RdlcLinuxLoop_t;
+
+/// io_uring后端定义，由xRdlcLinuxUringInit初始化，成员不应被用户直接修改
+typedef struct{
+    int ringFd;
+    uint32_t *sqHead;       ///< 提交队列：内核已取走的位置
+    uint32_t *sqTail;       ///< 提交队列：已发布给内核的位置
+    uint32_t sqMask;
+    uint32_t sqEntries;
+    uint32_t sqLocalTail;   ///< 提交队列：已填写还没发布的位置
+    uint32_t *cqHead;       ///< 完成队列
+    uint32_t *cqTail;
+    uint32_t cqMask;
+    void *sqes;
+    void *cqes;
+    void *ringMem;          ///< 映射进来的提交队列和完成队列
+    size_t ringMemSize;
+    size_t sqesSize;
+    void *bufRing;          ///< 提供给内核的读缓冲区环
+    uint8_t *rxBufs;        ///< 读缓冲区，rxBufCount块，每块rxBufSize字节
+    uint32_t rxBufSize;
+    uint16_t rxBufCount;
+    uint16_t bufTail;
+    uint8_t multishot;      ///< 内核是否支持多次完成的读请求，不支持时每次读完重新提交
+    uint64_t enterSyscalls; ///< 统计：io_uring_enter()次数
+}RdlcLinuxUring_t;
+
+/// 公有方法
+int xRdlcLinuxOpenSerial(const char *dev,int baudrate);
+int xRdlcLinuxLoopInit(RdlcLinuxLoop_t *loop,uint8_t *rxBuf,size_t rxBufSize);
+void vRdlcLinuxLoopDeinit(RdlcLinuxLoop_t *loop);
+int xRdlcLinuxLinkAdd(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,const RdlcLinuxLinkConfig_t *config);
+int xRdlcLinuxLinkRemove(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link);
+int xRdlcLinuxSend(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize);
+int xRdlcLinuxSendRaw(RdlcLinuxLoop_t *loop,RdlcLinuxLink_t *link,const uint8_t *data,size_t size);
+int xRdlcLinuxLoopRun(RdlcLinuxLoop_t *loop,int timeoutMs);
+
+int xRdlcLinuxUringInit(RdlcLinuxUring_t *ring,uint8_t *rxBufs,uint32_t rxBufSize,uint16_t rxBufCount);
+void vRdlcLinuxUringDeinit(RdlcLinuxUring_t *ring);
+int xRdlcLinuxUringLinkAdd(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,const RdlcLinuxLinkConfig_t *config);
+int xRdlcLinuxUringLinkRemove(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link);
+int xRdlcLinuxUringSend(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize);
+int xRdlcLinuxUringSendRaw(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,const uint8_t *data,size_t size);
+int xRdlcLinuxUringRun(RdlcLinuxUring_t *ring,int timeoutMs);
+
+#define RDLC_LINUX_RX_BUF_SIZE 65536 ///< 推荐的读缓冲区大小
+#define RDLC_LINUX_MAX_EVENTS  32    ///< 每次epoll_wait最多处理的就绪链路数
+#define RDLC_LINUX_URING_ENTRIES 256 ///< io_uring提交队列的长度，每条链路同时最多占用读、写、取消各一项
+#define RDLC_LINUX_URING_RX_BUF_SIZE  4096 ///< 推荐的io_uring读缓冲区每块大小
+#define RDLC_LINUX_URING_RX_BUF_COUNT 64   ///< 推荐的io_uring读缓冲区块数，必须是2的幂
+
+#ifdef __cplusplus
+}
+#endif
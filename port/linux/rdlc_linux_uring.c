@@ -0,0 +1,515 @@
+/**
+ * @file rdlc_linux_uring.c
+ * @brief RDLC的Linux传输层的io_uring后端：读请求常驻内核，读到的数据落在注册的缓冲区中直接送入RDLC解包，发送的帧批量提交
+ * @author 陈煜楷
+ * @version 1.1@2025-5-16
+ *
+ * 不依赖liburing，直接使用io_uring的系统调用。需要内核5.19(提供缓冲区环)，6.7起使用多次完成的读请求。
+**/
+
+#include "rdlc_linux.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#define RDLC_URING_OP_READ_MULTISHOT 49 ///< IORING_OP_READ_MULTISHOT，旧的内核头文件中没有
+#define RDLC_URING_BUF_GROUP 0          ///< 读缓冲区环的组号
+#define RDLC_URING_TAG_WRITE 1u         ///< user_data最低位：1为写请求，0为读请求；链路地址至少按8字节对齐
+
+/**
+ *@brief io_uring系统调用
+ *@addtogroup 支撑功能
+**/
+static int prvUringSetup(unsigned entries,struct io_uring_params *params)
+{
+    return (int)syscall(__NR_io_uring_setup,entries,params);
+}
+static int prvUringEnter(RdlcLinuxUring_t *ring,unsigned toSubmit,unsigned minComplete,unsigned flags,const void *arg,size_t argSize)
+{
+    ring->enterSyscalls++;
+    return (int)syscall(__NR_io_uring_enter,ring->ringFd,toSubmit,minComplete,flags,arg,argSize);
+}
+static int prvUringRegister(int ringFd,unsigned opcode,void *arg,unsigned count)
+{
+    return (int)syscall(__NR_io_uring_register,ringFd,opcode,arg,count);
+}
+
+/**
+ *@brief 把已填写的提交项发布给内核，返回内核还没取走的提交项数
+ *@addtogroup 支撑功能
+**/
+static unsigned prvUringPublish(RdlcLinuxUring_t *ring)
+{
+    __atomic_store_n(ring->sqTail,ring->sqLocalTail,__ATOMIC_RELEASE);
+    return ring->sqLocalTail - __atomic_load_n(ring->sqHead,__ATOMIC_ACQUIRE);
+}
+
+/**
+ *@brief 取一个空闲的提交项，提交队列满时先提交一次
+ *@addtogroup 支撑功能
+**/
+static struct io_uring_sqe *prvUringGetSqe(RdlcLinuxUring_t *ring)
+{
+    if (ring->sqLocalTail - __atomic_load_n(ring->sqHead,__ATOMIC_ACQUIRE) >= ring->sqEntries) {
+        if (prvUringEnter(ring,prvUringPublish(ring),0,0,NULL,0) < 0)
+            return NULL;
+        if (ring->sqLocalTail - __atomic_load_n(ring->sqHead,__ATOMIC_ACQUIRE) >= ring->sqEntries)
+            return NULL;
+    }
+    struct io_uring_sqe *sqe = &((struct io_uring_sqe *)ring->sqes)[ring->sqLocalTail & ring->sqMask];
+    memset(sqe,0,sizeof(struct io_uring_sqe));
+    ring->sqLocalTail++;
+    return sqe;
+}
+
+/**
+ *@brief 把一块读缓冲区还给内核
+ *@addtogroup 支撑功能
+**/
+static void prvUringRecycle(RdlcLinuxUring_t *ring,uint16_t bid)
+{
+    struct io_uring_buf_ring *bufRing = (struct io_uring_buf_ring *)ring->bufRing;
+    struct io_uring_buf *buf = &bufRing->bufs[ring->bufTail & (ring->rxBufCount - 1)];
+    buf->addr = (uint64_t)(uintptr_t)&ring->rxBufs[(size_t)bid * ring->rxBufSize];
+    buf->len = ring->rxBufSize;
+    buf->bid = bid;
+    ring->bufTail++;
+    __atomic_store_n(&bufRing->tail,ring->bufTail,__ATOMIC_RELEASE);
+}
+
+/**
+ *@brief 提交一个读请求，数据由内核从读缓冲区环中挑一块存放
+ *@addtogroup 支撑功能
+**/
+static int prvUringArmRead(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link)
+{
+    struct io_uring_sqe *sqe = prvUringGetSqe(ring);
+    if (sqe == NULL)
+        return RDLC_ERR_IO;
+    sqe->opcode = ring->multishot ? RDLC_URING_OP_READ_MULTISHOT : IORING_OP_READ;
+    sqe->fd = link->config.fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = RDLC_URING_BUF_GROUP;
+    sqe->len = ring->multishot ? 0 : ring->rxBufSize;
+    sqe->off = (uint64_t)-1;
+    sqe->user_data = (uint64_t)(uintptr_t)link;
+    link->rxArmed = 1;
+    link->uringOps++;
+    return RDLC_OK;
+}
+
+/**
+ *@brief 发送队列中有数据且没有写请求在内核中时，提交一个写请求，覆盖队列中全部待写的数据
+ *@addtogroup 支撑功能
+**/
+static int prvUringArmWrite(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link)
+{
+    if (link->txInflight || (link->txHead == link->txTail) || (link->state != RDLC_LINUX_LINK_OPEN))
+        return RDLC_OK;
+    struct io_uring_sqe *sqe = prvUringGetSqe(ring);
+    if (sqe == NULL)
+        return RDLC_ERR_IO;
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = link->config.fd;
+    sqe->addr = (uint64_t)(uintptr_t)&link->config.txBuf[link->txHead];
+    sqe->len = (uint32_t)(link->txTail - link->txHead);
+    sqe->off = (uint64_t)-1;
+    sqe->user_data = (uint64_t)(uintptr_t)link | RDLC_URING_TAG_WRITE;
+    link->txInflight = link->txTail - link->txHead;
+    link->uringOps++;
+    return RDLC_OK;
+}
+
+/**
+ *@brief 取消内核中这条链路的全部请求，没有请求或取消请求已经排入时直接返回
+ *@return 错误状态码，提交队列满、取消请求排不进去时返回RDLC_ERR_IO
+ *@addtogroup 支撑功能
+**/
+static int prvUringCancel(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link)
+{
+    if ((link->uringOps == 0) || link->uringCancel)
+        return RDLC_OK;
+    struct io_uring_sqe *sqe = prvUringGetSqe(ring);
+    if (sqe == NULL)
+        return RDLC_ERR_IO;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = link->config.fd;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    sqe->user_data = 0;
+    link->uringCancel = 1;
+    return RDLC_OK;
+}
+
+/**
+ *@brief 关闭链路：取消内核中这条链路的请求，通知用户；请求全部完成前链路仍不能释放
+ *@note  提交队列满时取消请求可能排不进去，由xRdlcLinuxUringLinkRemove重试
+ *@addtogroup 支撑功能
+**/
+static void prvUringLinkClose(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,int err)
+{
+    if (link->state != RDLC_LINUX_LINK_OPEN)
+        return;
+    link->state = RDLC_LINUX_LINK_CLOSED;
+    prvUringCancel(ring,link);
+    if (link->config.cbClosed)
+        link->config.cbClosed(link->config.protoHandle,link,err);
+}
+
+/**
+ *@brief 处理一个读完成：送入解包，某一帧出错时同一块中后面的帧照常解析，只计入rxErrors；归还缓冲区，读请求结束时重新提交
+ *@addtogroup 支撑功能
+**/
+static void prvUringOnRead(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,const struct io_uring_cqe *cqe)
+{
+    if (cqe->flags & IORING_CQE_F_BUFFER) {
+        uint16_t bid = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        if ((cqe->res > 0) && (link->state == RDLC_LINUX_LINK_OPEN)) {
+            link->rxBytes += cqe->res;
+            if (xRdlcReadBytes(link->config.protoHandle,&ring->rxBufs[(size_t)bid * ring->rxBufSize],(size_t)cqe->res) < 0)
+                link->rxErrors++;
+        }
+        prvUringRecycle(ring,bid);
+    }
+    if (cqe->flags & IORING_CQE_F_MORE)
+        return;
+
+    link->rxArmed = 0;
+    link->uringOps--;
+    if (link->state != RDLC_LINUX_LINK_OPEN)
+        return;
+    if ((cqe->res == -EINVAL) && ring->multishot) {
+        // 内核不认识多次完成的读请求，退回每次读完重新提交
+        ring->multishot = 0;
+        prvUringArmRead(ring,link);
+    }
+    else if ((cqe->res > 0) || (cqe->res == -ENOBUFS) || (cqe->res == -EINTR) || (cqe->res == -EAGAIN))
+        prvUringArmRead(ring,link);
+    else // 读到EOF或出错，伪终端对端关闭时读返回EIO
+        prvUringLinkClose(ring,link,(cqe->res < 0 && cqe->res != -EIO) ? -cqe->res : 0);
+}
+
+/**
+ *@brief 处理一个写完成：部分写时继续提交剩下的数据
+ *@addtogroup 支撑功能
+**/
+static void prvUringOnWrite(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,const struct io_uring_cqe *cqe)
+{
+    link->uringOps--;
+    link->txInflight = 0;
+    if (link->state != RDLC_LINUX_LINK_OPEN)
+        return;
+    if (cqe->res > 0) {
+        link->txHead += cqe->res;
+        link->txBytes += cqe->res;
+        if (link->txHead == link->txTail)
+            link->txHead = link->txTail = 0;
+        prvUringArmWrite(ring,link);
+    }
+    else if ((cqe->res == -EINTR) || (cqe->res == -EAGAIN))
+        prvUringArmWrite(ring,link);
+    else
+        prvUringLinkClose(ring,link,(cqe->res < 0) ? -cqe->res : 0);
+}
+
+/**
+ *@brief 处理完成队列中的全部完成项，返回处理的个数
+ *@addtogroup 支撑功能
+**/
+static int prvUringReap(RdlcLinuxUring_t *ring)
+{
+    int count = 0;
+    uint32_t head = *ring->cqHead;
+    uint32_t tail = __atomic_load_n(ring->cqTail,__ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const struct io_uring_cqe *cqe = &((struct io_uring_cqe *)ring->cqes)[head & ring->cqMask];
+        uint64_t userData = cqe->user_data;
+        if (userData != 0) {
+            RdlcLinuxLink_t *link = (RdlcLinuxLink_t *)(uintptr_t)(userData & ~(uint64_t)RDLC_URING_TAG_WRITE);
+            if (userData & RDLC_URING_TAG_WRITE)
+                prvUringOnWrite(ring,link,cqe);
+            else
+                prvUringOnRead(ring,link,cqe);
+        }
+        count++;
+        head++;
+        // 回调中可能又产生了新的完成项
+        if (head == tail) {
+            __atomic_store_n(ring->cqHead,head,__ATOMIC_RELEASE);
+            tail = __atomic_load_n(ring->cqTail,__ATOMIC_ACQUIRE);
+        }
+    }
+    __atomic_store_n(ring->cqHead,head,__ATOMIC_RELEASE);
+    return count;
+}
+
+/**
+ *@brief 为即将入队的size字节腾出连续空间；写请求在内核中时它覆盖的数据不能移动，只能使用队尾的空间
+ *@addtogroup 支撑功能
+**/
+static uint8_t *prvUringLinkReserve(RdlcLinuxLink_t *link,size_t size)
+{
+    size_t pending = link->txTail - link->txHead;
+    if (size > link->config.txBufSize - pending)
+        return NULL;
+    if (size > link->config.txBufSize - link->txTail) {
+        if (link->txInflight)
+            return NULL;
+        memmove(link->config.txBuf,&link->config.txBuf[link->txHead],pending);
+        link->txHead = 0;
+        link->txTail = pending;
+    }
+    return &link->config.txBuf[link->txTail];
+}
+
+/**
+ * @brief 初始化io_uring后端
+ *
+ * @param ring io_uring后端，由调用者分配
+ * @param rxBufs 读缓冲区，rxBufCount块，每块rxBufSize字节，由所有链路共享
+ * @param rxBufSize 每块读缓冲区的大小
+ * @param rxBufCount 读缓冲区块数，必须是2的幂；读到的数据送入解包后这块缓冲区立即归还
+ * @return int 错误状态码，内核不支持时返回RDLC_ERR_IO，此时应改用epoll后端
+ */
+int xRdlcLinuxUringInit(RdlcLinuxUring_t *ring,uint8_t *rxBufs,uint32_t rxBufSize,uint16_t rxBufCount)
+{
+    if (!ring || !rxBufs || (rxBufSize == 0) || (rxBufCount == 0) || (rxBufCount & (rxBufCount - 1)))
+        return RDLC_ERR_INVALID_ARG;
+    memset(ring,0,sizeof(RdlcLinuxUring_t));
+    ring->ringFd = -1;
+
+    // 只有本线程提交，完成项推迟到io_uring_enter等待时再处理，省掉内核打断用户态的开销；旧内核不支持时退回默认
+    struct io_uring_params params;
+    memset(&params,0,sizeof(params));
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    int fd = prvUringSetup(RDLC_LINUX_URING_ENTRIES,&params);
+    if ((fd < 0) && (errno == EINVAL)) {
+        memset(&params,0,sizeof(params));
+        fd = prvUringSetup(RDLC_LINUX_URING_ENTRIES,&params);
+    }
+    if (fd < 0)
+        return RDLC_ERR_IO;
+    ring->ringFd = fd;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+        vRdlcLinuxUringDeinit(ring);
+        return RDLC_ERR_IO;
+    }
+
+    size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->ringMemSize = (sqSize > cqSize) ? sqSize : cqSize;
+    ring->ringMem = mmap(NULL,ring->ringMemSize,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,fd,IORING_OFF_SQ_RING);
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL,ring->sqesSize,PROT_READ | PROT_WRITE,MAP_SHARED | MAP_POPULATE,fd,IORING_OFF_SQES);
+    ring->bufRing = mmap(NULL,(size_t)rxBufCount * sizeof(struct io_uring_buf),PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+    if ((ring->ringMem == MAP_FAILED) || (ring->sqes == MAP_FAILED) || (ring->bufRing == MAP_FAILED)) {
+        vRdlcLinuxUringDeinit(ring);
+        return RDLC_ERR_IO;
+    }
+
+    uint8_t *mem = (uint8_t *)ring->ringMem;
+    ring->sqHead = (uint32_t *)(mem + params.sq_off.head);
+    ring->sqTail = (uint32_t *)(mem + params.sq_off.tail);
+    ring->sqMask = *(uint32_t *)(mem + params.sq_off.ring_mask);
+    ring->sqEntries = params.sq_entries;
+    ring->sqLocalTail = *ring->sqTail;
+    ring->cqHead = (uint32_t *)(mem + params.cq_off.head);
+    ring->cqTail = (uint32_t *)(mem + params.cq_off.tail);
+    ring->cqMask = *(uint32_t *)(mem + params.cq_off.ring_mask);
+    ring->cqes = mem + params.cq_off.cqes;
+    // 提交项的下标与提交队列中的位置一一对应，只需设置一次
+    uint32_t *array = (uint32_t *)(mem + params.sq_off.array);
+    for (uint32_t i = 0; i < params.sq_entries; i++)
+        array[i] = i;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg,0,sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)ring->bufRing;
+    reg.ring_entries = rxBufCount;
+    reg.bgid = RDLC_URING_BUF_GROUP;
+    if (prvUringRegister(fd,IORING_REGISTER_PBUF_RING,&reg,1) != 0) {
+        munmap(ring->bufRing,(size_t)rxBufCount * sizeof(struct io_uring_buf));
+        ring->bufRing = NULL;
+        vRdlcLinuxUringDeinit(ring);
+        return RDLC_ERR_IO;
+    }
+    ring->rxBufs = rxBufs;
+    ring->rxBufSize = rxBufSize;
+    ring->rxBufCount = rxBufCount;
+    for (uint16_t i = 0; i < rxBufCount; i++)
+        prvUringRecycle(ring,i);
+    ring->multishot = 1;
+    return RDLC_OK;
+}
+
+/**
+ * @brief 释放io_uring后端，调用前应移除全部链路
+ *
+ * @param ring io_uring后端
+ */
+void vRdlcLinuxUringDeinit(RdlcLinuxUring_t *ring)
+{
+    if (!ring || ring->ringFd < 0)
+        return;
+    if (ring->bufRing && ring->bufRing != MAP_FAILED) {
+        struct io_uring_buf_reg reg;
+        memset(&reg,0,sizeof(reg));
+        reg.bgid = RDLC_URING_BUF_GROUP;
+        prvUringRegister(ring->ringFd,IORING_UNREGISTER_PBUF_RING,&reg,1);
+        munmap(ring->bufRing,(size_t)ring->rxBufCount * sizeof(struct io_uring_buf));
+    }
+    if (ring->sqes && ring->sqes != MAP_FAILED)
+        munmap(ring->sqes,ring->sqesSize);
+    if (ring->ringMem && ring->ringMem != MAP_FAILED)
+        munmap(ring->ringMem,ring->ringMemSize);
+    close(ring->ringFd);
+    ring->ringFd = -1;
+}
+
+/**
+ * @brief 把一条链路加入io_uring后端，立即提交常驻的读请求
+ *
+ * @param ring io_uring后端
+ * @param link 链路，由调用者分配，xRdlcLinuxUringLinkRemove返回之前不能释放
+ * @param config 链路配置，会被拷贝
+ * @return int 错误状态码
+ *
+ * @note fd会被设为非阻塞：阻塞的tty上写请求会在提交它的线程中睡眠，而这个线程也负责读对端，会互相等死；
+ *       非阻塞时内核在fd不可读写时自己等待就绪，不会返回EAGAIN
+ */
+int xRdlcLinuxUringLinkAdd(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,const RdlcLinuxLinkConfig_t *config)
+{
+    if (!ring || !link || !config || config->fd < 0 || !config->protoHandle || !config->txBuf || config->txBufSize == 0)
+        return RDLC_ERR_INVALID_ARG;
+    int flags = fcntl(config->fd,F_GETFL);
+    if (flags < 0 || fcntl(config->fd,F_SETFL,flags | O_NONBLOCK) != 0)
+        return RDLC_ERR_IO;
+
+    memset(link,0,sizeof(RdlcLinuxLink_t));
+    memcpy(&link->config,config,sizeof(RdlcLinuxLinkConfig_t));
+    link->state = RDLC_LINUX_LINK_OPEN;
+    int ret = prvUringArmRead(ring,link);
+    if (ret != RDLC_OK)
+        link->state = RDLC_LINUX_LINK_IDLE;
+    return ret;
+}
+
+/**
+ * @brief 移除一条链路：取消内核中这条链路的请求并等待它们完成，发送队列中没写完的数据被丢弃，fd由调用者关闭
+ *
+ * @param ring io_uring后端
+ * @param link 链路
+ * @return int 错误状态码，提交队列满、取消请求排不进去时返回RDLC_ERR_IO，此时链路已关闭但不能释放，稍后可以再次调用
+ *
+ * @note 等待期间其他链路的数据照常解包；不能在RDLC回调中调用
+ */
+int xRdlcLinuxUringLinkRemove(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link)
+{
+    if (!ring || !link)
+        return RDLC_ERR_INVALID_ARG;
+    // 主动移除不通知用户
+    RdlcLinuxOnClosed_fptr cbClosed = link->config.cbClosed;
+    link->config.cbClosed = NULL;
+    prvUringLinkClose(ring,link,0);
+    link->config.cbClosed = cbClosed;
+
+    // 取消请求没排进去时先处理完成队列再重试，仍排不进去就返回，不等待不会结束的请求
+    if (prvUringCancel(ring,link) != RDLC_OK) {
+        prvUringReap(ring);
+        if (prvUringCancel(ring,link) != RDLC_OK)
+            return RDLC_ERR_IO;
+    }
+    while (link->uringOps > 0) {
+        if ((prvUringEnter(ring,prvUringPublish(ring),1,IORING_ENTER_GETEVENTS,NULL,0) < 0) && (errno != EINTR))
+            return RDLC_ERR_IO;
+        prvUringReap(ring);
+    }
+    link->state = RDLC_LINUX_LINK_IDLE;
+    link->txHead = link->txTail = 0;
+    return RDLC_OK;
+}
+
+/**
+ * @brief 封包一帧并排入发送队列，写请求在下一次xRdlcLinuxUringRun时与其他链路的请求一起提交
+ *
+ * @param ring io_uring后端
+ * @param link 链路
+ * @param addr 目的地址和源地址
+ * @param payload 载荷
+ * @param payloadSize 载荷长度
+ * @return int 错误状态码，发送队列放不下这一帧时返回RDLC_ERR_BUFFER_TOO_SHORT，这一帧不会入队
+ *
+ * @note 写请求在内核中时，它覆盖的数据不能移动，队尾空间不足时即使队首已空也会返回RDLC_ERR_BUFFER_TOO_SHORT
+ */
+int xRdlcLinuxUringSend(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize)
+{
+    if (!ring || !link || link->state != RDLC_LINUX_LINK_OPEN)
+        return RDLC_ERR_NOT_ALLOWED;
+    int frameSize = xRdlcGetFrameSize(link->config.protoHandle,addr,payload,payloadSize);
+    if (frameSize < 0)
+        return frameSize;
+    uint8_t *frame = prvUringLinkReserve(link,(size_t)frameSize);
+    if (frame == NULL)
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    int len = xRdlcWriteBytes(link->config.protoHandle,addr,payload,payloadSize,frame,(size_t)frameSize);
+    if (len < 0)
+        return len;
+    link->txTail += len;
+    return prvUringArmWrite(ring,link);
+}
+
+/**
+ * @brief 把已经封包好的数据排入发送队列，写请求在下一次xRdlcLinuxUringRun时提交
+ *
+ * @param ring io_uring后端
+ * @param link 链路
+ * @param data 数据
+ * @param size 数据长度
+ * @return int 错误状态码，发送队列放不下时返回RDLC_ERR_BUFFER_TOO_SHORT，数据不会入队
+ */
+int xRdlcLinuxUringSendRaw(RdlcLinuxUring_t *ring,RdlcLinuxLink_t *link,const uint8_t *data,size_t size)
+{
+    if (!ring || !link || link->state != RDLC_LINUX_LINK_OPEN)
+        return RDLC_ERR_NOT_ALLOWED;
+    if (!data && size)
+        return RDLC_ERR_INVALID_ARG;
+    uint8_t *dst = prvUringLinkReserve(link,size);
+    if (dst == NULL)
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    if (size > 0)
+        memcpy(dst,data,size);
+    link->txTail += size;
+    return prvUringArmWrite(ring,link);
+}
+
+/**
+ * @brief 运行一轮：一次io_uring_enter提交所有排队的写请求并等待完成，再处理全部完成项
+ *
+ * @param ring io_uring后端
+ * @param timeoutMs 最长等待时间，取-1一直等待，取0只提交和检查不等待
+ * @return int 处理的完成项数，超时返回0，出错时返回错误码
+ *
+ * @note 解包回调在本函数中执行，回调中可以调用xRdlcLinuxUringSend
+ */
+int xRdlcLinuxUringRun(RdlcLinuxUring_t *ring,int timeoutMs)
+{
+    if (!ring || ring->ringFd < 0)
+        return RDLC_ERR_INVALID_ARG;
+    struct __kernel_timespec ts = {
+        .tv_sec = (timeoutMs > 0) ? timeoutMs / 1000 : 0,
+        .tv_nsec = (timeoutMs > 0) ? (long long)(timeoutMs % 1000) * 1000000 : 0,
+    };
+    struct io_uring_getevents_arg arg;
+    memset(&arg,0,sizeof(arg));
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+
+    unsigned flags = IORING_ENTER_GETEVENTS | ((timeoutMs >= 0) ? IORING_ENTER_EXT_ARG : 0);
+    int ret = prvUringEnter(ring,prvUringPublish(ring),(timeoutMs != 0) ? 1 : 0,flags,
+                            (timeoutMs >= 0) ? &arg : NULL,(timeoutMs >= 0) ? sizeof(arg) : 0);
+    if ((ret < 0) && (errno != ETIME) && (errno != EINTR) && (errno != EBUSY))
+        return RDLC_ERR_IO;
+    return prvUringReap(ring);
+}
@@ -14,14 +14,44 @@
 
 #define BYTE_ESCAPE 0xFF /// 转义字符
 #define BYTE_HEAD   0xC0 /// 包头
+#define BYTE_HEAD_WIDE 0xC1 /// 宽长度帧的包头，载荷长度为4字节
 #define BYTE_TAIL   0x0C /// 包尾
 
-#if (RDLC_CRC16_USE_CALCULATE == 1) && (RDLC_CRC16_USE_TABLE == 1)
+#define RDLC_TX_BLOCK_SIZE 2048 /// 封包时每块载荷的最大长度，一块写完立刻累计CRC，保证CRC读到的数据还在缓存里
+
+#define RDLC_CRC16_INIT RDLC_CRC16_INIT_VALUE /// CRC16初值
+
+#define RDLC_CRC16_METHODS (RDLC_CRC16_USE_CALCULATE + RDLC_CRC16_USE_NIBBLE + RDLC_CRC16_USE_TABLE + \
+                            RDLC_CRC16_USE_SLICING4 + RDLC_CRC16_USE_SLICING8)
+#if RDLC_CRC16_METHODS > 1
     #error "RDLC: you can only choose one of the crc16 methods."
-#elif (RDLC_CRC16_USE_CALCULATE == 0) && (RDLC_CRC16_USE_TABLE == 0)
+#elif RDLC_CRC16_METHODS == 0
     #error "RDLC: You must define one CRC16 method."
 #endif
 
+#if (RDLC_SIMD_ENABLE == 1) && defined(__GNUC__) && defined(__x86_64__)
+    #define RDLC_SIMD_X86  1
+    #include <immintrin.h>
+#elif (RDLC_SIMD_ENABLE == 1) && defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+    #define RDLC_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// 无进位乘法折叠CRC需要字节表收尾，只和查表类引擎搭配
+#if (RDLC_CRC16_CLMUL_ENABLE == 1) && (RDLC_CRC16_USE_CALCULATE == 0) && (RDLC_CRC16_USE_NIBBLE == 0)
+    #if defined(__GNUC__) && defined(__x86_64__)
+        #define RDLC_CRC16_FOLD_PCLMUL 1
+        #include <immintrin.h>
+    #elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+        #define RDLC_CRC16_FOLD_PMULL 1
+        #include <arm_neon.h>
+        #if defined(__linux__)
+            #include <sys/auxv.h>
+            #include <asm/hwcap.h>
+        #endif
+    #endif
+#endif
+
 
 
 /**
@@ -47,9 +77,8 @@ static inline void Log(RdlcStaticHandle_t *handle,RdlcLogLevel_t level,const cha
  *@addtogroup 支撑功能
 **/
 #if RDLC_CRC16_USE_CALCULATE == 1
-static inline uint16_t prvGetCrc16(const uint8_t* data, size_t length)
+static inline uint16_t prvCrc16Update(uint16_t crc,const uint8_t* data, size_t length)
 {
-    uint16_t crc = 0xFFFF;
     for (size_t i = 0; i < length; ++i) {
         crc ^= data[i];
         for (int j = 0; j < 8; ++j) {
@@ -61,7 +90,27 @@ static inline uint16_t prvGetCrc16(const uint8_t* data, size_t length)
     }
     return crc;
 }
-#elif RDLC_CRC16_USE_TABLE == 1
+static inline void prvCrc16Init(void) {}
+#elif RDLC_CRC16_USE_NIBBLE == 1
+// 字节表是线性的：table[x] = table[x & 0x0F] ^ table[x & 0xF0]，因此两张16项的表就能一次处理一个字节
+static const uint16_t crc16_nibble_low[16] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+};
+static const uint16_t crc16_nibble_high[16] = {
+    0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+    0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
+};
+static inline uint16_t prvCrc16Update(uint16_t crc,const uint8_t* data, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t table_index = crc ^ data[i];
+        crc = (crc >> 8) ^ crc16_nibble_low[table_index & 0x0F] ^ crc16_nibble_high[table_index >> 4];
+    }
+    return crc;
+}
+static inline void prvCrc16Init(void) {}
+#else
 static const uint16_t crc16_table[256] = {
     0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
     0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
@@ -96,16 +145,420 @@ static const uint16_t crc16_table[256] = {
     0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
     0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
 };
-static inline uint16_t prvGetCrc16(const uint8_t* data, size_t length)
+static inline uint16_t prvCrc16UpdateByTable(uint16_t crc,const uint8_t* data, size_t length)
 {
-    uint16_t crc = 0xFFFF;
     for (size_t i = 0; i < length; ++i) {
         uint8_t table_index = crc ^ data[i];
         crc = (crc >> 8) ^ crc16_table[table_index];
     }
     return crc;
 }
+#if RDLC_CRC16_USE_TABLE == 1
+static inline uint16_t prvCrc16UpdateSoft(uint16_t crc,const uint8_t* data, size_t length)
+{
+    return prvCrc16UpdateByTable(crc,data,length);
+}
+static inline void prvCrc16SoftInit(void) {}
+#else
+// crc16_slicing[k][x]：字节x后面再跟k个0字节的CRC，由字节表在运行时生成
+#define RDLC_CRC16_SLICES ((RDLC_CRC16_USE_SLICING8 == 1) ? 8 : 4)
+static uint16_t crc16_slicing[RDLC_CRC16_SLICES][256];
+static bool crc16_slicing_ready = false;
+
+/**
+ *@brief 生成slicing表，在构造实例时调用
+ *@note  多个线程可能同时构造实例：表写完后才以release语义发布标志，看到标志的线程一定看到完整的表；
+ *       同时生成的线程写入的是相同的值
+ *@addtogroup 支撑功能
+**/
+static void prvCrc16SoftInit(void)
+{
+    if (__atomic_load_n(&crc16_slicing_ready,__ATOMIC_ACQUIRE))
+        return;
+    for (int i = 0; i < 256; i++) {
+        uint16_t crc = crc16_table[i];
+        crc16_slicing[0][i] = crc;
+        for (int k = 1; k < RDLC_CRC16_SLICES; k++) {
+            crc = (crc >> 8) ^ crc16_table[crc & 0xFF];
+            crc16_slicing[k][i] = crc;
+        }
+    }
+    __atomic_store_n(&crc16_slicing_ready,true,__ATOMIC_RELEASE);
+}
+static inline uint16_t prvCrc16UpdateSoft(uint16_t crc,const uint8_t* data, size_t length)
+{
+    while (length >= RDLC_CRC16_SLICES) {
+#if RDLC_CRC16_USE_SLICING8 == 1
+        crc = crc16_slicing[7][(uint8_t)(data[0] ^ crc)] ^ crc16_slicing[6][(uint8_t)(data[1] ^ (crc >> 8))] ^
+              crc16_slicing[5][data[2]] ^ crc16_slicing[4][data[3]] ^
+              crc16_slicing[3][data[4]] ^ crc16_slicing[2][data[5]] ^
+              crc16_slicing[1][data[6]] ^ crc16_slicing[0][data[7]];
+#else
+        crc = crc16_slicing[3][(uint8_t)(data[0] ^ crc)] ^ crc16_slicing[2][(uint8_t)(data[1] ^ (crc >> 8))] ^
+              crc16_slicing[1][data[2]] ^ crc16_slicing[0][data[3]];
+#endif
+        data += RDLC_CRC16_SLICES;
+        length -= RDLC_CRC16_SLICES;
+    }
+    return prvCrc16UpdateByTable(crc,data,length);
+}
+#endif
+/**
+ *@brief 无进位乘法折叠CRC16(0xA001)，每次把16字节的累加块折叠到后面的块上，最后剩下的16字节和尾巴交给查表引擎
+ *@note  反射域中累加块低64位是高次项，乘以x^(D+63) mod P，高64位乘以x^(D-1) mod P，即折叠距离D位；
+ *       常数都是bitreverse64(x^e mod P)，多出的一个x由反射乘法的错位补上。
+ *       CRC是线性的，初值直接异或进第一个块的低16位即可，因此分段调用的结果与查表完全一致
+ *@addtogroup 支撑功能
+**/
+#if defined(RDLC_CRC16_FOLD_PCLMUL) || defined(RDLC_CRC16_FOLD_PMULL)
+#define RDLC_CRC16_FOLD 1
+#define RDLC_CRC16_FOLD_MIN 64                      ///< 短于此长度时查表更快
+#define RDLC_CRC16_FOLD_K127 0xC100000000000000ULL  ///< x^127 mod P，折叠距离128位
+#define RDLC_CRC16_FOLD_K191 0xCCD0000000000000ULL  ///< x^191 mod P
+#define RDLC_CRC16_FOLD_K511 0x8101000000000000ULL  ///< x^511 mod P，折叠距离512位(4路并行)
+#define RDLC_CRC16_FOLD_K575 0xC450000000000000ULL  ///< x^575 mod P
+
+typedef uint16_t (*RdlcCrc16Fold_fptr)(uint16_t crc,const uint8_t *data,size_t length);
+
+#if defined(RDLC_CRC16_FOLD_PCLMUL)
+__attribute__((target("pclmul")))
+static inline __m128i prvCrc16FoldStep(__m128i acc,__m128i k,__m128i next)
+{
+    __m128i lo = _mm_clmulepi64_si128(acc,k,0x00);
+    __m128i hi = _mm_clmulepi64_si128(acc,k,0x11);
+    return _mm_xor_si128(_mm_xor_si128(lo,hi),next);
+}
+
+__attribute__((target("pclmul")))
+static uint16_t prvCrc16FoldPclmul(uint16_t crc,const uint8_t *data,size_t length)
+{
+    const __m128i k128 = _mm_set_epi64x((long long)RDLC_CRC16_FOLD_K127,(long long)RDLC_CRC16_FOLD_K191);
+    const __m128i k512 = _mm_set_epi64x((long long)RDLC_CRC16_FOLD_K511,(long long)RDLC_CRC16_FOLD_K575);
+    __m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)data),_mm_cvtsi32_si128(crc));
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(data + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(data + 32));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(data + 48));
+    data += 64;
+    length -= 64;
+
+    for (; length >= 64; data += 64, length -= 64) {
+        x0 = prvCrc16FoldStep(x0,k512,_mm_loadu_si128((const __m128i *)data));
+        x1 = prvCrc16FoldStep(x1,k512,_mm_loadu_si128((const __m128i *)(data + 16)));
+        x2 = prvCrc16FoldStep(x2,k512,_mm_loadu_si128((const __m128i *)(data + 32)));
+        x3 = prvCrc16FoldStep(x3,k512,_mm_loadu_si128((const __m128i *)(data + 48)));
+    }
+    x0 = prvCrc16FoldStep(x0,k128,x1);
+    x0 = prvCrc16FoldStep(x0,k128,x2);
+    x0 = prvCrc16FoldStep(x0,k128,x3);
+    for (; length >= 16; data += 16, length -= 16)
+        x0 = prvCrc16FoldStep(x0,k128,_mm_loadu_si128((const __m128i *)data));
+
+    uint8_t rest[16];
+    _mm_storeu_si128((__m128i *)rest,x0);
+    crc = prvCrc16UpdateSoft(0,rest,sizeof(rest));
+    return prvCrc16UpdateSoft(crc,data,length);
+}
+#elif defined(RDLC_CRC16_FOLD_PMULL)
+#if defined(__clang__)
+    #define RDLC_TARGET_PMULL __attribute__((target("aes")))
+#else
+    #define RDLC_TARGET_PMULL __attribute__((target("+crypto")))
+#endif
+
+RDLC_TARGET_PMULL
+static inline uint8x16_t prvCrc16FoldStep(uint8x16_t acc,poly64x2_t k,uint8x16_t next)
+{
+    poly64x2_t a = vreinterpretq_p64_u8(acc);
+    uint8x16_t lo = vreinterpretq_u8_p128(vmull_p64(vgetq_lane_p64(a,0),vgetq_lane_p64(k,0)));
+    uint8x16_t hi = vreinterpretq_u8_p128(vmull_high_p64(a,k));
+    return veorq_u8(veorq_u8(lo,hi),next);
+}
+
+RDLC_TARGET_PMULL
+static uint16_t prvCrc16FoldPmull(uint16_t crc,const uint8_t *data,size_t length)
+{
+    const poly64x2_t k128 = vreinterpretq_p64_u64(vcombine_u64(vcreate_u64(RDLC_CRC16_FOLD_K191),vcreate_u64(RDLC_CRC16_FOLD_K127)));
+    const poly64x2_t k512 = vreinterpretq_p64_u64(vcombine_u64(vcreate_u64(RDLC_CRC16_FOLD_K575),vcreate_u64(RDLC_CRC16_FOLD_K511)));
+    uint8x16_t x0 = veorq_u8(vld1q_u8(data),vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(crc),vcreate_u64(0))));
+    uint8x16_t x1 = vld1q_u8(data + 16);
+    uint8x16_t x2 = vld1q_u8(data + 32);
+    uint8x16_t x3 = vld1q_u8(data + 48);
+    data += 64;
+    length -= 64;
+
+    for (; length >= 64; data += 64, length -= 64) {
+        x0 = prvCrc16FoldStep(x0,k512,vld1q_u8(data));
+        x1 = prvCrc16FoldStep(x1,k512,vld1q_u8(data + 16));
+        x2 = prvCrc16FoldStep(x2,k512,vld1q_u8(data + 32));
+        x3 = prvCrc16FoldStep(x3,k512,vld1q_u8(data + 48));
+    }
+    x0 = prvCrc16FoldStep(x0,k128,x1);
+    x0 = prvCrc16FoldStep(x0,k128,x2);
+    x0 = prvCrc16FoldStep(x0,k128,x3);
+    for (; length >= 16; data += 16, length -= 16)
+        x0 = prvCrc16FoldStep(x0,k128,vld1q_u8(data));
+
+    uint8_t rest[16];
+    vst1q_u8(rest,x0);
+    crc = prvCrc16UpdateSoft(0,rest,sizeof(rest));
+    return prvCrc16UpdateSoft(crc,data,length);
+}
+#endif
+
+static RdlcCrc16Fold_fptr prvCrc16Fold = NULL;
+
+/**
+ *@brief 根据CPU特性选择折叠内核，CPU不支持时保持NULL，退回查表
+ *@addtogroup 支撑功能
+**/
+static void prvCrc16FoldInit(void)
+{
+#if defined(RDLC_CRC16_FOLD_PCLMUL)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul"))
+        prvCrc16Fold = prvCrc16FoldPclmul;
+#elif defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES) || defined(__APPLE__)
+    prvCrc16Fold = prvCrc16FoldPmull;
+#elif defined(__linux__) && defined(HWCAP_PMULL)
+    if (getauxval(AT_HWCAP) & HWCAP_PMULL)
+        prvCrc16Fold = prvCrc16FoldPmull;
+#endif
+}
+#else
+static inline void prvCrc16FoldInit(void) {}
+#endif
+
+static inline uint16_t prvCrc16Update(uint16_t crc,const uint8_t* data, size_t length)
+{
+#if defined(RDLC_CRC16_FOLD)
+    if ((length >= RDLC_CRC16_FOLD_MIN) && (prvCrc16Fold != NULL))
+        return prvCrc16Fold(crc,data,length);
+#endif
+    return prvCrc16UpdateSoft(crc,data,length);
+}
+static void prvCrc16Init(void)
+{
+    prvCrc16SoftInit();
+    prvCrc16FoldInit();
+}
+#endif
+/**
+ *@brief 使用实例的CRC引擎累计CRC16，硬件CRC接口优先
+ *@addtogroup 支撑功能
+**/
+static inline uint16_t prvCrc16(RdlcStaticHandle_t *handle,uint16_t crc,const uint8_t* data, size_t length)
+{
+    if (handle->port.portCrc16 != NULL)
+        return handle->port.portCrc16(crc,data,length);
+    return prvCrc16Update(crc,data,length);
+}
+static inline uint16_t prvGetCrc16(RdlcStaticHandle_t *handle,const uint8_t* data, size_t length)
+{
+    return prvCrc16(handle,RDLC_CRC16_INIT,data,length);
+}
+
+/**
+ *@brief 转义字符扫描内核：在data中查找第一个转义字符，并把它之前的字节拷贝到dst(dst可以为NULL)
+ *@return 转义字符所在的下标，找不到则返回size
+ *@note   标量版本是参考实现，SIMD版本由prvSimdInit在运行时选择
+ *@addtogroup 支撑功能
+**/
+typedef size_t (*RdlcScan_fptr)(uint8_t *dst,const uint8_t *data,size_t size);
+
+static size_t prvScanEscapeScalar(uint8_t *dst,const uint8_t *data,size_t size)
+{
+    const uint8_t *pos = (const uint8_t *)memchr(data,BYTE_ESCAPE,size);
+    size_t span = (pos == NULL) ? size : (size_t)(pos - data);
+    if (dst != NULL)
+        memcpy(dst,data,span);
+    return span;
+}
+
+#if defined(RDLC_SIMD_X86)
+static size_t prvScanEscapeSse2(uint8_t *dst,const uint8_t *data,size_t size)
+{
+    const __m128i escape = _mm_set1_epi8((char)BYTE_ESCAPE);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block,escape));
+        if (mask != 0) {
+            size_t hit = __builtin_ctz(mask);
+            if (dst != NULL)
+                memcpy(dst + i,data + i,hit);
+            return i + hit;
+        }
+        if (dst != NULL)
+            _mm_storeu_si128((__m128i *)(dst + i),block);
+    }
+    return i + prvScanEscapeScalar((dst != NULL) ? (dst + i) : NULL,data + i,size - i);
+}
+
+__attribute__((target("avx2")))
+static size_t prvScanEscapeAvx2(uint8_t *dst,const uint8_t *data,size_t size)
+{
+    const __m256i escape = _mm256_set1_epi8((char)BYTE_ESCAPE);
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m256i block0 = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i block1 = _mm256_loadu_si256((const __m256i *)(data + i + 32));
+        __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(block0,escape),_mm256_cmpeq_epi8(block1,escape));
+        if (!_mm256_testz_si256(match,match))
+            break;
+        if (dst != NULL) {
+            _mm256_storeu_si256((__m256i *)(dst + i),block0);
+            _mm256_storeu_si256((__m256i *)(dst + i + 32),block1);
+        }
+    }
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block,escape));
+        if (mask != 0) {
+            size_t hit = __builtin_ctz(mask);
+            if (dst != NULL)
+                memcpy(dst + i,data + i,hit);
+            return i + hit;
+        }
+        if (dst != NULL)
+            _mm256_storeu_si256((__m256i *)(dst + i),block);
+    }
+    return i + prvScanEscapeSse2((dst != NULL) ? (dst + i) : NULL,data + i,size - i);
+}
+#elif defined(RDLC_SIMD_NEON)
+static size_t prvScanEscapeNeon(uint8_t *dst,const uint8_t *data,size_t size)
+{
+    const uint8x16_t escape = vdupq_n_u8(BYTE_ESCAPE);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t block = vld1q_u8(data + i);
+        uint8x16_t match = vceqq_u8(block,escape);
+        // 每个字节压缩成4位，得到64位掩码
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match),4)),0);
+        if (mask != 0) {
+            size_t hit = (size_t)__builtin_ctzll(mask) >> 2;
+            if (dst != NULL)
+                memcpy(dst + i,data + i,hit);
+            return i + hit;
+        }
+        if (dst != NULL)
+            vst1q_u8(dst + i,block);
+    }
+    return i + prvScanEscapeScalar((dst != NULL) ? (dst + i) : NULL,data + i,size - i);
+}
+#endif
+
+/**
+ *@brief 转义字符计数内核：统计data中转义字符的个数
+ *@note  SIMD版本每个字节通道最多累加255次比较结果，再横向求和
+ *@addtogroup 支撑功能
+**/
+typedef size_t (*RdlcCount_fptr)(const uint8_t *data,size_t size);
+
+static size_t prvCountEscapeScalar(const uint8_t *data,size_t size)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < size; i++)
+        count += (data[i] == BYTE_ESCAPE);
+    return count;
+}
+
+#if defined(RDLC_SIMD_X86)
+static size_t prvCountEscapeSse2(const uint8_t *data,size_t size)
+{
+    const __m128i escape = _mm_set1_epi8((char)BYTE_ESCAPE);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 16 <= size) {
+        size_t end = (size - i > 255 * 16) ? (i + 255 * 16) : size;
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 16 <= end; i += 16)
+            acc = _mm_sub_epi8(acc,_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)),escape));
+        __m128i sum = _mm_sad_epu8(acc,_mm_setzero_si128());
+        count += (size_t)_mm_cvtsi128_si32(sum) + (size_t)_mm_extract_epi16(sum,4);
+    }
+    return count + prvCountEscapeScalar(data + i,size - i);
+}
+
+__attribute__((target("avx2")))
+static size_t prvCountEscapeAvx2(const uint8_t *data,size_t size)
+{
+    const __m256i escape = _mm256_set1_epi8((char)BYTE_ESCAPE);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 32 <= size) {
+        size_t end = (size - i > 255 * 32) ? (i + 255 * 32) : size;
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 32 <= end; i += 32)
+            acc = _mm256_sub_epi8(acc,_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i)),escape));
+        __m256i sum = _mm256_sad_epu8(acc,_mm256_setzero_si256());
+        __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum),_mm256_extracti128_si256(sum,1));
+        count += (size_t)_mm_cvtsi128_si32(half) + (size_t)_mm_extract_epi16(half,4);
+    }
+    // 尾调用SSE2版本时编译器不会插入vzeroupper，之后的非VEX指令(例如PCLMUL折叠)会付出状态切换的代价
+    _mm256_zeroupper();
+    return count + prvCountEscapeSse2(data + i,size - i);
+}
+#elif defined(RDLC_SIMD_NEON)
+static size_t prvCountEscapeNeon(const uint8_t *data,size_t size)
+{
+    const uint8x16_t escape = vdupq_n_u8(BYTE_ESCAPE);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 16 <= size) {
+        size_t end = (size - i > 255 * 16) ? (i + 255 * 16) : size;
+        uint8x16_t acc = vdupq_n_u8(0);
+        for (; i + 16 <= end; i += 16)
+            acc = vsubq_u8(acc,vceqq_u8(vld1q_u8(data + i),escape));
+        count += vaddlvq_u8(acc);
+    }
+    return count + prvCountEscapeScalar(data + i,size - i);
+}
+#endif
+
+static RdlcScan_fptr prvScanEscape = prvScanEscapeScalar;
+static RdlcCount_fptr prvCountEscape = prvCountEscapeScalar;
+
+/**
+ *@brief 根据CPU特性选择扫描和计数内核，在构造实例时调用
+ *@note  选择结果只和CPU有关，多个实例并发调用时写入的是同一个值
+ *@addtogroup 支撑功能
+**/
+static void prvSimdInit(void)
+{
+#if defined(RDLC_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        prvScanEscape = prvScanEscapeAvx2;
+        prvCountEscape = prvCountEscapeAvx2;
+    }
+    else {
+        prvScanEscape = prvScanEscapeSse2;
+        prvCountEscape = prvCountEscapeSse2;
+    }
+#elif defined(RDLC_SIMD_NEON)
+    prvScanEscape = prvScanEscapeNeon;
+    prvCountEscape = prvCountEscapeNeon;
 #endif
+}
+
+/**
+ *@brief 在字节流中查找下一个转义字符
+ *@return 转义字符所在的下标，找不到则返回size
+ *@addtogroup 支撑功能
+**/
+static inline size_t prvFindEscape(const uint8_t *data,size_t size)
+{
+    return prvScanEscape(NULL,data,size);
+}
+/**
+ *@brief 拷贝字节流，直到遇到转义字符为止
+ *@return 拷贝的字节数，即转义字符所在的下标，找不到则返回size
+ *@addtogroup 支撑功能
+**/
+static inline size_t prvCopyUntilEscape(uint8_t *dst,const uint8_t *data,size_t size)
+{
+    return prvScanEscape(dst,data,size);
+}
 
 /**
  *@brief 复位接收缓冲区
@@ -115,6 +568,7 @@ static inline void prvRxBufferReset(RdlcStaticHandle_t *handle)
 {
     handle->rxIndexer = 0;
     handle->payloadSize = 0;
+    handle->rxCrc = RDLC_CRC16_INIT;
 }
 /**
  *@brief 安全写入接收缓冲区
@@ -136,10 +590,12 @@ static inline int prvRxBufferFeed(RdlcStaticHandle_t *handle,uint8_t data)
  *@brief 从完整接收的缓冲区中读取载荷长度字段
  *@addtogroup 接收缓冲区操作
 **/
-static inline uint16_t prvRxBufferGetPayloadLen(RdlcStaticHandle_t *handle)
+static inline uint32_t prvRxBufferGetPayloadLen(RdlcStaticHandle_t *handle)
 {
-    // 接收缓冲区内的结构：源地址 目的地址 载荷长度 载荷 CRC16
-    uint16_t res = (((uint16_t)handle->rxBuf[3])<<8) | ((uint16_t)handle->rxBuf[2]);
+    // 接收缓冲区内的结构：源地址 目的地址 载荷长度(2或4字节) 载荷 CRC16
+    uint32_t res = (((uint32_t)handle->rxBuf[3])<<8) | ((uint32_t)handle->rxBuf[2]);
+    if (handle->rxHeadSize == 6)
+        res |= (((uint32_t)handle->rxBuf[5])<<24) | (((uint32_t)handle->rxBuf[4])<<16);
     return res;
 }
 /**
@@ -158,10 +614,10 @@ static inline RdlcAddr_t prvRxBufferGetAddr(RdlcStaticHandle_t *handle)
  *@brief 从完整接收的缓冲区中读取CRC字段所在的下标
  *@addtogroup 接收缓冲区操作
 **/
-static inline uint16_t prvRxBufferGetCrcIndex(RdlcStaticHandle_t *handle)
+static inline size_t prvRxBufferGetCrcIndex(RdlcStaticHandle_t *handle)
 {
     // 接收缓冲区内的结构：源地址 目的地址 载荷长度 载荷 CRC16
-    uint16_t res = 4 + prvRxBufferGetPayloadLen(handle);
+    size_t res = handle->rxHeadSize + (size_t)prvRxBufferGetPayloadLen(handle);
     return res;
 }
 /**
@@ -171,7 +627,7 @@ static inline uint16_t prvRxBufferGetCrcIndex(RdlcStaticHandle_t *handle)
 static inline uint8_t *prvRxBufferGetPayload(RdlcStaticHandle_t *handle)
 {
     // 接收缓冲区内的结构：源地址 目的地址 载荷长度 载荷 CRC16
-    return &(handle->rxBuf[4]);
+    return &(handle->rxBuf[handle->rxHeadSize]);
 }
 /**
  *@brief 从完整接收的缓冲区中读取CRC字段
@@ -179,8 +635,8 @@ static inline uint8_t *prvRxBufferGetPayload(RdlcStaticHandle_t *handle)
 **/
 static inline uint16_t prvRxBufferGetCrcFromFrame(RdlcStaticHandle_t *handle)
 {
-    uint16_t payloadSize = prvRxBufferGetPayloadLen(handle);
-    uint16_t res = (((uint16_t)handle->rxBuf[payloadSize+5])<<8) | ((uint16_t)handle->rxBuf[payloadSize+4]);
+    size_t crcIndex = prvRxBufferGetCrcIndex(handle);
+    uint16_t res = (((uint16_t)handle->rxBuf[crcIndex+1])<<8) | ((uint16_t)handle->rxBuf[crcIndex]);
     return res;
 }
 /**
@@ -189,16 +645,76 @@ static inline uint16_t prvRxBufferGetCrcFromFrame(RdlcStaticHandle_t *handle)
 **/
 static inline uint16_t prvRxBufferGetCrcFromCalc(RdlcStaticHandle_t *handle)
 {
-    uint16_t res = prvGetCrc16(prvRxBufferGetPayload(handle),prvRxBufferGetPayloadLen(handle));
+#if RDLC_CRC16_INCREMENTAL == 1
+    // 载荷到达时已经逐段累计
+    return handle->rxCrc;
+#else
+    uint16_t res = prvGetCrc16(handle,prvRxBufferGetPayload(handle),prvRxBufferGetPayloadLen(handle));
     return res;
+#endif
+}
+/**
+ *@brief 把目的地址过滤器展开成位图，filter为NULL时接收所有地址
+ *@addtogroup 接收缓冲区操作
+**/
+static void prvRxAcceptMapInit(RdlcStaticHandle_t *handle,const RdlcAddrFilter_t *filter)
+{
+    uint8_t mode = filter ? filter->mode : RDLC_ADDR_FILTER_NONE;
+    for (int i = 0; i < 8; i++)
+        handle->acceptMap[i] = (mode == RDLC_ADDR_FILTER_BITMAP) ? filter->bitmap[i] : ((mode == RDLC_ADDR_FILTER_NONE) ? 0xFFFFFFFFu : 0);
+    if (mode == RDLC_ADDR_FILTER_EXACT || mode == RDLC_ADDR_FILTER_MASK) {
+        uint8_t mask = (mode == RDLC_ADDR_FILTER_EXACT) ? 0xFF : filter->mask;
+        for (int addr = 0; addr < 256; addr++)
+            if ((addr & mask) == (filter->addr & mask))
+                handle->acceptMap[addr >> 5] |= 1u << (addr & 31);
+    }
+}
+/**
+ *@brief 目的地址是否通过过滤
+ *@addtogroup 接收缓冲区操作
+**/
+static inline bool prvRxAccept(const RdlcStaticHandle_t *handle,uint8_t dstAddr)
+{
+    return (handle->acceptMap[dstAddr >> 5] >> (dstAddr & 31)) & 1u;
+}
+/**
+ *@brief 把解析完成的载荷交给用户回调
+ *@addtogroup 接收缓冲区操作
+**/
+static inline void prvRxDeliver(RdlcStaticHandle_t *handle,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize)
+{
+    if (handle->dispatch != NULL) {
+        const RdlcRoute_t *route = &handle->dispatch->routes[addr.dstAddr];
+        if ((route->handler == NULL) || ((route->srcAddr != RDLC_ADDR_ANY) && (route->srcAddr != addr.srcAddr)))
+            route = &handle->dispatch->fallback;
+        if (route->handler != NULL) {
+            route->handler(handle,addr,payload,payloadSize,route->ctx);
+            Log(handle,RDLC_LOG_DEBUG,"crc pass and dispatched");
+        }
+        else
+            Log(handle,RDLC_LOG_DEBUG,"crc pass but no route for %#hhX->%#hhX",addr.srcAddr,addr.dstAddr);
+    }
+    else if (handle->cbParsedWide != NULL) {
+        handle->cbParsedWide(handle,addr,payload,payloadSize);
+        Log(handle,RDLC_LOG_DEBUG,"crc pass and callback");
+    }
+    else if (handle->cbParsed == NULL)
+        Log(handle,RDLC_LOG_DEBUG,"crc pass but no callback specified");
+    else if (payloadSize > 0xFFFF)
+        Log(handle,RDLC_LOG_WARN,"payload of %u bytes needs cbParsedWide",(unsigned)payloadSize);
+    else {
+        handle->cbParsed(handle,addr,payload,payloadSize);
+        Log(handle,RDLC_LOG_DEBUG,"crc pass and callback");
+    }
 }
 /**
  *@brief 给定协议参数，获取最小的接收缓冲区的长度
  *@addtogroup 接收缓冲区评估
 **/
-static inline int prvRxBufferEstimateSize(uint16_t payloadMaxSize)
+static inline size_t prvRxBufferEstimateSize(uint32_t payloadMaxSize,uint16_t flags)
 {
-    return 4 + payloadMaxSize + 2;// 地址 + 载荷长度 + 载荷 + CRC
+    size_t headSize = (flags & RDLC_FLAG_WIDE_LENGTH) ? 6 : 4;
+    return headSize + payloadMaxSize + 2;// 地址 + 载荷长度 + 载荷 + CRC
 }
 /**
  *@brief 给定接收缓冲区的长度，获取最大允许的协议参数
@@ -212,11 +728,11 @@ static inline int prvRxBufferEstimateMaxPayloadSize(uint16_t bufferSize)
  *@brief 转义写入发送缓冲区(帧中数据)
  *@addtogroup 发送缓冲区操作
 **/
-static inline int prvTxBufferFeedCommon(RdlcStaticHandle_t *handle,uint8_t *buffer,uint16_t size,uint16_t *iter,uint8_t data)
+static inline int prvTxBufferFeedCommon(RdlcStaticHandle_t *handle,uint8_t *buffer,size_t size,size_t *iter,uint8_t data)
 {
     if (*iter == size) {
         Log(handle,RDLC_LOG_ERR,"TxBuffer overflow!");
-        return RDLC_ERR_NOT_ALLOWED;
+        return RDLC_ERR_BUFFER_TOO_SHORT;
     }
 
     if (data == BYTE_ESCAPE) {
@@ -224,7 +740,7 @@ static inline int prvTxBufferFeedCommon(RdlcStaticHandle_t *handle,uint8_t *buff
         (*iter)++;
         if (*iter == size) {
             Log(handle,RDLC_LOG_ERR,"TxBuffer overflow!");
-            return RDLC_ERR_NOT_ALLOWED;
+            return RDLC_ERR_BUFFER_TOO_SHORT;
         }
     }
 
@@ -236,18 +752,18 @@ static inline int prvTxBufferFeedCommon(RdlcStaticHandle_t *handle,uint8_t *buff
  *@brief 转义写入发送缓冲区(帧头帧尾数据)
  *@addtogroup 发送缓冲区操作
 **/
-static inline int prvTxBufferFeedFrame(RdlcStaticHandle_t *handle,uint8_t *buffer,uint16_t size,uint16_t *iter,uint8_t frameData)
+static inline int prvTxBufferFeedFrame(RdlcStaticHandle_t *handle,uint8_t *buffer,size_t size,size_t *iter,uint8_t frameData)
 {
     if (*iter == size) {
         Log(handle,RDLC_LOG_ERR,"TxBuffer overflow!");
-        return RDLC_ERR_NOT_ALLOWED;
+        return RDLC_ERR_BUFFER_TOO_SHORT;
     }
 
     buffer[*iter] = BYTE_ESCAPE;
     (*iter)++;
     if (*iter == size) {
         Log(handle,RDLC_LOG_ERR,"TxBuffer overflow!");
-        return RDLC_ERR_NOT_ALLOWED;
+        return RDLC_ERR_BUFFER_TOO_SHORT;
     }
 
     buffer[*iter] = frameData;
@@ -257,13 +773,15 @@ static inline int prvTxBufferFeedFrame(RdlcStaticHandle_t *handle,uint8_t *buffe
 
 /**
  *@brief 在发送缓冲区中的指定位置写入帧头
+ *@note  载荷超过65535字节时写宽长度帧头：0xFF 0xC1，载荷长度为4字节
  *@addtogroup 发送缓冲区操作
 **/
-static inline int prvTxBufferFeedHead(RdlcStaticHandle_t *handle,RdlcAddr_t addr,uint8_t *buffer,uint16_t size,uint16_t *iter,uint16_t payloadSize,uint8_t ctrlByte)
+static inline int prvTxBufferFeedHead(RdlcStaticHandle_t *handle,RdlcAddr_t addr,uint8_t *buffer,size_t size,size_t *iter,size_t payloadSize,uint8_t ctrlByte)
 {
     int err;
+    bool wide = (payloadSize > 0xFFFF);
     // 包头
-    err = prvTxBufferFeedFrame(handle,buffer,size,iter,BYTE_HEAD);
+    err = prvTxBufferFeedFrame(handle,buffer,size,iter,wide ? BYTE_HEAD_WIDE : BYTE_HEAD);
     if (err != RDLC_OK) return err;
 
     // 源地址
@@ -281,34 +799,59 @@ static inline int prvTxBufferFeedHead(RdlcStaticHandle_t *handle,RdlcAddr_t addr
     if (err != RDLC_OK) return err;
     err = prvTxBufferFeedCommon(handle,buffer,size,iter,payloadHigh);
     if (err != RDLC_OK) return err;
+    if (wide) {
+        err = prvTxBufferFeedCommon(handle,buffer,size,iter,(uint8_t)(payloadSize >> 16));
+        if (err != RDLC_OK) return err;
+        err = prvTxBufferFeedCommon(handle,buffer,size,iter,(uint8_t)(payloadSize >> 24));
+        if (err != RDLC_OK) return err;
+    }
 
     return RDLC_OK;
 }
 /**
- *@brief 在发送缓冲区中的指定位置写入载荷
+ *@brief 在发送缓冲区中的指定位置写入载荷，同时累计载荷的CRC
+ *@param crc16 输入当前的CRC，输出累计了载荷之后的CRC
+ *@note  单趟完成：载荷按RDLC_TX_BLOCK_SIZE分块，块内不含转义字符的连续字节整段拷贝，遇到0xFF再补一个转义字节，
+ *       整块写完立刻累计这一块的CRC。每段都先检查剩余空间，转义字符再多也只会报错而不会越界
  *@addtogroup 发送缓冲区操作
 **/
-static inline int prvTxBufferFeedPayload(RdlcStaticHandle_t *handle,uint8_t *buffer,uint16_t bufferSize,uint16_t *iter,uint8_t *payload,uint16_t payloadSize)
+static inline int prvTxBufferFeedPayload(RdlcStaticHandle_t *handle,uint8_t *buffer,size_t bufferSize,size_t *iter,
+                                         const uint8_t *payload,size_t payloadSize,uint16_t *crc16)
 {
-    // 提前预判是否会超出范围
-    uint8_t count = 0;
-    for(uint16_t i=0;i<payloadSize;i++)
-        if (payload[i] == BYTE_ESCAPE)
-            count++;
-    if (*iter + count >= bufferSize) {
-        Log(handle,RDLC_LOG_ERR,"TxBuffer feed payload overflow!");
-        return RDLC_ERR_NOT_ALLOWED;
-    }
+    size_t block;
+    for (size_t base = 0; base < payloadSize; base += block) {
+        block = payloadSize - base;
+        if (block > RDLC_TX_BLOCK_SIZE)
+            block = RDLC_TX_BLOCK_SIZE;
 
-    for(uint16_t i=0;i<payloadSize;i++)
-        prvTxBufferFeedCommon(handle,buffer,bufferSize,iter,payload[i]);
+        size_t pos = 0;
+        while (pos < block) {
+            size_t room = bufferSize - *iter;
+            size_t limit = (block - pos < room) ? (block - pos) : room;
+            size_t span = prvCopyUntilEscape(&buffer[*iter],&payload[base + pos],limit);
+            *iter += span;
+            pos += span;
+            if (pos == block)
+                break;
+            // 剩余空间不够，或者payload[base+pos]是0xFF且放不下两个0xFF
+            if ((span == room) || (room - span < 2)) {
+                Log(handle,RDLC_LOG_ERR,"TxBuffer feed payload overflow!");
+                return RDLC_ERR_BUFFER_TOO_SHORT;
+            }
+            buffer[*iter] = BYTE_ESCAPE;
+            buffer[*iter + 1] = BYTE_ESCAPE;
+            *iter += 2;
+            pos++;
+        }
+        *crc16 = prvCrc16(handle,*crc16,&payload[base],block);
+    }
     return RDLC_OK;
 }
 /**
  *@brief 在发送缓冲区中的指定位置写入帧尾
  *@addtogroup 发送缓冲区操作
 **/
-static inline int prvTxBufferFeedTail(RdlcStaticHandle_t *handle,uint8_t *buffer,uint16_t bufferSize,uint16_t *iter,uint16_t crc16)
+static inline int prvTxBufferFeedTail(RdlcStaticHandle_t *handle,uint8_t *buffer,size_t bufferSize,size_t *iter,uint16_t crc16)
 {
     //crc
     uint8_t crcHigh = (crc16 & 0xFF00) >> 8;
@@ -325,15 +868,90 @@ static inline int prvTxBufferFeedTail(RdlcStaticHandle_t *handle,uint8_t *buffer
     if (err != RDLC_OK) return err;
     return RDLC_OK;
 }
+/**
+ *@brief 把若干载荷片段封成一帧
+ *@param payloadSize 片段长度之和，由调用者检查过不超过payloadMaxSize
+ *@return 封包后的长度，或错误码
+ *@addtogroup 发送缓冲区操作
+**/
+static int prvTxEncode(RdlcStaticHandle_t *handle,RdlcAddr_t addr,const RdlcFragment_t *fragments,uint16_t fragmentCount,
+                       size_t payloadSize,uint8_t *frameBuf,size_t frameMaxSize)
+{
+    size_t itr = 0;
+    uint16_t crc16 = RDLC_CRC16_INIT;
+    int err;
+
+    err = prvTxBufferFeedHead(handle,addr,frameBuf,frameMaxSize,&itr,payloadSize,0x0);
+    if (err != RDLC_OK) return err;
+
+    for (uint16_t i = 0; i < fragmentCount; i++) {
+        err = prvTxBufferFeedPayload(handle,frameBuf,frameMaxSize,&itr,fragments[i].data,fragments[i].size,&crc16);
+        if (err != RDLC_OK) return err;
+    }
+
+    err = prvTxBufferFeedTail(handle,frameBuf,frameMaxSize,&itr,crc16);
+    if (err != RDLC_OK) return err;
+
+    return (int)itr;
+}
+/**
+ *@brief 在片段数组末尾追加一个片段
+ *@addtogroup 发送缓冲区操作
+**/
+static inline int prvTxIovPush(RdlcStaticHandle_t *handle,RdlcFragment_t *iov,uint16_t iovMaxCount,uint16_t *count,const uint8_t *data,uint16_t size)
+{
+    if (*count == iovMaxCount) {
+        Log(handle,RDLC_LOG_ERR,"TxIov overflow!");
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+    iov[*count].data = data;
+    iov[*count].size = size;
+    (*count)++;
+    return RDLC_OK;
+}
+/**
+ *@brief 原地转义：从后往前把payload[0..size)展开到payload[0..size+escapeCount)
+ *@param escapeCount 载荷中0xFF的个数，由调用者事先统计，缓冲区在载荷之后至少还有这么多空间
+ *@note  从后往前搬时目标总在源之后，不会覆盖还没搬的字节，因此不需要临时缓冲区；
+ *       每次取8字节，不含0xFF(取反后不含0)时整字搬移，否则逐字节展开；第一个0xFF之前的字节不需要移动
+ *@addtogroup 发送缓冲区操作
+**/
+static inline void prvTxEscapeBackward(uint8_t *payload,size_t size,size_t escapeCount)
+{
+    size_t end = size;
+    while (escapeCount > 0) {
+        size_t base = (end >= 8) ? (end - 8) : 0;
+        if (end - base == 8) {
+            uint64_t word;
+            memcpy(&word,&payload[base],8);
+            uint64_t inverse = ~word;
+            if (((inverse - 0x0101010101010101ULL) & ~inverse & 0x8080808080808080ULL) == 0) {
+                memcpy(&payload[base + escapeCount],&word,8);
+                end = base;
+                continue;
+            }
+        }
+        while ((end > base) && (escapeCount > 0)) {
+            end--;
+            uint8_t byte = payload[end];
+            payload[end + escapeCount] = byte;
+            if (byte == BYTE_ESCAPE) {
+                escapeCount--;
+                payload[end + escapeCount] = BYTE_ESCAPE;
+            }
+        }
+    }
+}
 /**
  *@brief 给定协议参数，获取最小的发送缓冲区的长度
  *@addtogroup 发送缓冲区评估
 **/
-static inline int prvTxBufferEstimateSize(uint16_t msgMaxSize,uint16_t msgMaxEscapeSize)
+static inline size_t prvTxBufferEstimateSize(uint32_t msgMaxSize,uint32_t msgMaxEscapeSize)
 {
-    // 0xFF 0xC0 0xFF SRC 0xFF DST 0xFF LENL 0xFF LENH
+    // 0xFF 0xC0 0xFF SRC 0xFF DST 0xFF LENL 0xFF LENH (宽长度帧再加 0xFF LEN2 0xFF LEN3)
     // 0xFF CRCL 0xFF CRCH 0xFF 0x0C
-    return 10 + msgMaxSize + msgMaxEscapeSize + 6;// 最大转义头 + 数据 + 转义 + 最大转义尾
+    size_t headSize = (msgMaxSize > 0xFFFF) ? 14 : 10;
+    return headSize + (size_t)msgMaxSize + msgMaxEscapeSize + 6;// 最大转义头 + 数据 + 转义 + 最大转义尾
     // 此处修改请同步到rdlc.h中的宏
 }
 /**
@@ -345,44 +963,162 @@ static inline int prvTxBufferEstimateMessageSize(uint16_t bufferSize)
     return bufferSize - 16;
 }
 /**
- *@brief 转义状态机
- *@param byte 转义前的字节
- *@param isFrame 是否是帧头帧尾
- *@return 正数代表转义出的字符，负数代表尚未完成转义或出了问题
- *@addtogroup 状态机
+ *@brief 检查配置：超过65535字节的载荷需要宽长度帧，最大帧长不能超出int能表示的范围
+ *@addtogroup 发送缓冲区评估
 **/
-static inline int prvRxFsmEscape(uint8_t *stateEscape,uint8_t byte,bool *isFrame)
+static inline bool prvConfigIsValid(const RdlcConfig_t *config)
 {
-    switch(*stateEscape)
-    {
-        // 如果这个字节是转义字节，就等到下个字节；否则返回这个字节
-        case RDLC_STATE_ESCAPE_WAIT:
-            if (byte == BYTE_ESCAPE){
-                *stateEscape = RDLC_STATE_ESCAPE_GET;
-                *isFrame = false;
-                return RDLC_NOT_FINISH;
-            }
-            else {
-                *isFrame = false;
-                return byte;
-            }
-        break;
+    if ((config->msgMaxSize > 0xFFFF) && !(config->flags & RDLC_FLAG_WIDE_LENGTH))
+        return false;
+    if (config->addrFilter && (config->addrFilter->mode > RDLC_ADDR_FILTER_BITMAP))
+        return false;
+    return ((uint64_t)config->msgMaxSize + config->msgMaxEscapeSize + 20 <= INT32_MAX);
+}
+/**
+ *@brief 给定地址和载荷，获取封包后的精确长度
+ *@note  载荷按RDLC_TX_BLOCK_SIZE分块计数转义字符并累计CRC，CRC本身也可能需要转义
+ *@addtogroup 发送缓冲区评估
+**/
+static inline int prvTxBufferExactSize(RdlcStaticHandle_t *handle,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize)
+{
+    uint16_t crc16 = RDLC_CRC16_INIT;
+    size_t lengthSize = (payloadSize > 0xFFFF) ? 4 : 2;
+    size_t size = 2 + 2 + lengthSize + payloadSize + 2 + 2;// 帧头 + 地址 + 载荷长度 + 载荷 + CRC + 帧尾
 
-        // 只有正确转义才会返回字节，否则返回错误码
-        case RDLC_STATE_ESCAPE_GET:
-            *stateEscape = RDLC_STATE_ESCAPE_WAIT;
-            if (byte == BYTE_ESCAPE) {
-                *isFrame = false;
-                return BYTE_ESCAPE;
-            }
-            else if (byte == BYTE_HEAD) {
-                *isFrame = true;
-                return BYTE_HEAD;
-            }
-            else if (byte == BYTE_TAIL) {
-                *isFrame = true;
-                return BYTE_TAIL;
-            }
+    size_t block;
+    for (size_t base = 0; base < payloadSize; base += block) {
+        block = payloadSize - base;
+        if (block > RDLC_TX_BLOCK_SIZE)
+            block = RDLC_TX_BLOCK_SIZE;
+        size += prvCountEscape(&payload[base],block);
+        crc16 = prvCrc16(handle,crc16,&payload[base],block);
+    }
+
+    const uint8_t fields[8] = {addr.srcAddr,addr.dstAddr,
+                               (uint8_t)(crc16 & 0x00FF),(uint8_t)((crc16 & 0xFF00) >> 8),
+                               (uint8_t)(payloadSize & 0x00FF),(uint8_t)((payloadSize & 0xFF00) >> 8),
+                               (uint8_t)(payloadSize >> 16),(uint8_t)(payloadSize >> 24)};
+    size += prvCountEscapeScalar(fields,4 + lengthSize);
+    return (int)size;
+}
+/**
+ *@brief 帧池：framePoolCount个定长块组成的空闲链表，取出和归还都是一次CAS，不加锁
+ *@note  链表头的高16位是版本号，每次修改加1，防止其他线程在两次读取之间取走又归还同一块造成ABA
+ *@addtogroup 帧池
+**/
+#define RDLC_FRAME_POOL_END 0xFFFF ///< 空闲链表的结尾
+#define RDLC_FRAME_POOL_ALIGN 8    ///< 块跨度的对齐
+
+/**
+ *@brief 由旧的链表头和新的块号生成新的链表头，版本号加1
+ *@addtogroup 帧池
+**/
+static inline uint32_t prvFramePoolHead(uint32_t head,uint16_t index)
+{
+    return ((head + 0x10000u) & 0xFFFF0000u) | index;
+}
+/**
+ *@brief 一次分配count个块和链表数组，所有块串成空闲链表
+ *@addtogroup 帧池
+**/
+static int prvFramePoolCreate(RdlcStaticHandle_t *handle,uint16_t count)
+{
+    if (count == 0)
+        return RDLC_OK;
+    if (count >= RDLC_FRAME_POOL_END)
+        return RDLC_ERR_INVALID_ARG;
+
+    size_t frameSize = prvTxBufferEstimateSize(handle->payloadMaxSize,handle->payloadMaxEscapeSize);
+    if (frameSize > 0xFFFF)
+        return RDLC_ERR_INVALID_ARG;
+    handle->frameBlockSize = (frameSize + RDLC_FRAME_POOL_ALIGN - 1) & ~(size_t)(RDLC_FRAME_POOL_ALIGN - 1);
+    handle->framePool = (uint8_t *)handle->port.portMalloc(handle->frameBlockSize * count + sizeof(uint16_t) * count);
+    if (handle->framePool == NULL)
+        return RDLC_ERR_NO_MEM;
+
+    handle->framePoolNext = (uint16_t *)&handle->framePool[handle->frameBlockSize * count];
+    for (uint16_t i = 0; i < count; i++)
+        handle->framePoolNext[i] = (i + 1 < count) ? (i + 1) : RDLC_FRAME_POOL_END;
+    handle->framePoolCount = count;
+    handle->framePoolHead = 0;
+    return RDLC_OK;
+}
+/**
+ *@brief 从空闲链表头取出一块
+ *@return 帧池已空时返回NULL
+ *@addtogroup 帧池
+**/
+static uint8_t *prvFramePoolTake(RdlcStaticHandle_t *handle)
+{
+    uint32_t head = __atomic_load_n(&handle->framePoolHead,__ATOMIC_ACQUIRE);
+    for (;;) {
+        uint16_t index = head & 0xFFFF;
+        if (index == RDLC_FRAME_POOL_END)
+            return NULL;
+        uint16_t next = __atomic_load_n(&handle->framePoolNext[index],__ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&handle->framePoolHead,&head,prvFramePoolHead(head,next),true,
+                                        __ATOMIC_ACQUIRE,__ATOMIC_ACQUIRE))
+            return &handle->framePool[handle->frameBlockSize * index];
+    }
+}
+/**
+ *@brief 把一块归还到空闲链表头
+ *@return frame不属于帧池时返回false
+ *@addtogroup 帧池
+**/
+static bool prvFramePoolGive(RdlcStaticHandle_t *handle,uint8_t *frame)
+{
+    if ((handle->framePool == NULL) || (frame < handle->framePool) ||
+        (frame >= handle->framePool + handle->frameBlockSize * handle->framePoolCount))
+        return false;
+    uint16_t index = (uint16_t)((size_t)(frame - handle->framePool) / handle->frameBlockSize);
+
+    uint32_t head = __atomic_load_n(&handle->framePoolHead,__ATOMIC_RELAXED);
+    do {
+        __atomic_store_n(&handle->framePoolNext[index],(uint16_t)(head & 0xFFFF),__ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n(&handle->framePoolHead,&head,prvFramePoolHead(head,index),true,
+                                          __ATOMIC_RELEASE,__ATOMIC_RELAXED));
+    return true;
+}
+/**
+ *@brief 转义状态机
+ *@param byte 转义前的字节
+ *@param isFrame 是否是帧头帧尾
+ *@return 正数代表转义出的字符，负数代表尚未完成转义或出了问题
+ *@addtogroup 状态机
+**/
+static inline int prvRxFsmEscape(uint8_t *stateEscape,uint8_t byte,bool *isFrame)
+{
+    switch(*stateEscape)
+    {
+        // 如果这个字节是转义字节，就等到下个字节；否则返回这个字节
+        case RDLC_STATE_ESCAPE_WAIT:
+            if (byte == BYTE_ESCAPE){
+                *stateEscape = RDLC_STATE_ESCAPE_GET;
+                *isFrame = false;
+                return RDLC_NOT_FINISH;
+            }
+            else {
+                *isFrame = false;
+                return byte;
+            }
+        break;
+
+        // 只有正确转义才会返回字节，否则返回错误码
+        case RDLC_STATE_ESCAPE_GET:
+            *stateEscape = RDLC_STATE_ESCAPE_WAIT;
+            if (byte == BYTE_ESCAPE) {
+                *isFrame = false;
+                return BYTE_ESCAPE;
+            }
+            else if ((byte == BYTE_HEAD) || (byte == BYTE_HEAD_WIDE)) {
+                *isFrame = true;
+                return byte;
+            }
+            else if (byte == BYTE_TAIL) {
+                *isFrame = true;
+                return BYTE_TAIL;
+            }
             else {
                 *isFrame = false;
                 return RDLC_ERR_NOT_ALLOWED;
@@ -391,12 +1127,43 @@ static inline int prvRxFsmEscape(uint8_t *stateEscape,uint8_t byte,bool *isFrame
     }
     return RDLC_NOT_FINISH;
 }
+/**
+ *@brief  收齐载荷长度后检查它，超过msgMaxSize时跳过这一帧，不再等到接收缓冲区越界
+ *@return 同prvRxFsmParse
+ *@note   载荷长度为0的帧(如心跳)是合法的，直接等待CRC
+ *@addtogroup 状态机
+**/
+static inline int prvRxCheckPayloadLen(RdlcStaticHandle_t *handle)
+{
+    handle->payloadSize = prvRxBufferGetPayloadLen(handle);
+    if (handle->payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_WARN,"invalid payload length %u",(unsigned)handle->payloadSize);
+        prvRxBufferReset(handle);
+        handle->stateParse = RDLC_STATE_PARSE_SKIP;
+        return RDLC_ERR_NOT_ALLOWED;
+    }
+    handle->rxCrc = RDLC_CRC16_INIT;
+    handle->stateParse = (handle->payloadSize == 0) ? RDLC_STATE_PARSE_GET_CRCL : RDLC_STATE_PARSE_GET_PAYLOAD;
+    return RDLC_NOT_FINISH;
+}
+/**
+ *@brief  判断解转义后的字节是否是本实例接受的帧头
+ *@addtogroup 状态机
+**/
+static inline bool prvRxIsHead(RdlcStaticHandle_t *handle,uint8_t byte,bool isFrame)
+{
+    if (isFrame == false)
+        return false;
+    return (byte == BYTE_HEAD) || ((byte == BYTE_HEAD_WIDE) && (handle->flags & RDLC_FLAG_WIDE_LENGTH));
+}
 /**
  *@brief  带有冗余越界保护的解析状态机
  *@param  byte 解转义后的字节
  *@param  isFrame 是否是帧头帧尾
  *@return 1成功-1失败0尚未完成
  *@note   冗余保护：不仅在收到载荷长度时检查越界，也在接收的过程中检查越界
+ *@note   重新同步：帧头帧尾只会以转义形式出现，帧内任何位置收到帧头都说明上一帧被截断，立即从这个帧头开始新的一帧；
+ *        帧尾之前收到帧尾同样说明被截断，丢弃这一帧
  *@addtogroup 状态机
 **/
 static inline int prvRxFsmParse(RdlcStaticHandle_t *handle,uint8_t byte,bool isFrame)
@@ -404,14 +1171,34 @@ static inline int prvRxFsmParse(RdlcStaticHandle_t *handle,uint8_t byte,bool isF
     uint16_t crcFromBuf;
     uint16_t crcFromFrame;
 
+    if ((isFrame == true) && (handle->stateParse != RDLC_STATE_PARSE_WAIT_HEAD) && (handle->stateParse != RDLC_STATE_PARSE_SKIP)) {
+        if (prvRxIsHead(handle,byte,isFrame)) {
+            Log(handle,RDLC_LOG_WARN,"frame truncated by a new head,resync");
+            prvRxBufferReset(handle);
+            handle->stateParse = RDLC_STATE_PARSE_WAIT_HEAD;
+        }
+        else if ((byte == BYTE_TAIL) && (handle->stateParse != RDLC_STATE_PARSE_GET_TAIL)) {
+            Log(handle,RDLC_LOG_WARN,"frame truncated by an early tail");
+            prvRxBufferReset(handle);
+            handle->stateParse = RDLC_STATE_PARSE_WAIT_HEAD;
+            return RDLC_ERR_CRC;
+        }
+    }
+
     switch(handle->stateParse)
     {
         // 等待帧头
         case RDLC_STATE_PARSE_WAIT_HEAD:
             Log(handle,RDLC_LOG_DEBUG,"state=WaitHead,read=%#hhX",byte);
 
-            if ((byte == BYTE_HEAD) && (isFrame == true))// 只有正确的帧头才会往下走，因此也不必在后面的状态中考虑第二次碰到帧头怎么办
+            if ((byte == BYTE_HEAD) && (isFrame == true)) {
+                handle->rxHeadSize = 4;
                 handle->stateParse = RDLC_STATE_PARSE_GET_SRCADDR;
+            }
+            else if ((byte == BYTE_HEAD_WIDE) && (isFrame == true) && (handle->flags & RDLC_FLAG_WIDE_LENGTH)) {
+                handle->rxHeadSize = 6;
+                handle->stateParse = RDLC_STATE_PARSE_GET_SRCADDR;
+            }
         break;
 
         // 等待源地址
@@ -421,13 +1208,27 @@ static inline int prvRxFsmParse(RdlcStaticHandle_t *handle,uint8_t byte,bool isF
             handle->stateParse = RDLC_STATE_PARSE_GET_DSTADDR;
         break;
 
-        // 等待目标地址
+        // 等待目标地址，不是发给本机的帧不再缓存，也不计算CRC
         case RDLC_STATE_PARSE_GET_DSTADDR:
             Log(handle,RDLC_LOG_DEBUG,"state=WaitDstAddr,read=%#hhX",byte);
+            if (!prvRxAccept(handle,byte)) {
+                prvRxBufferReset(handle);
+                handle->stateParse = RDLC_STATE_PARSE_SKIP;
+                break;
+            }
             prvRxBufferFeed(handle,byte);
             handle->stateParse = RDLC_STATE_PARSE_GET_LENL;
         break;
 
+        // 跳过本帧：载荷中的0xFF都被转义，帧尾和帧头只会以转义形式出现，不需要跟踪长度
+        case RDLC_STATE_PARSE_SKIP:
+            if (isFrame == true) {
+                handle->stateParse = RDLC_STATE_PARSE_WAIT_HEAD;
+                if (byte != BYTE_TAIL)
+                    return prvRxFsmParse(handle,byte,isFrame);
+            }
+        break;
+
         // 等待载荷长度低八位
         case RDLC_STATE_PARSE_GET_LENL:
             Log(handle,RDLC_LOG_DEBUG,"state=WaitPayloadLenL,read=%#hhX",byte);
@@ -440,14 +1241,32 @@ static inline int prvRxFsmParse(RdlcStaticHandle_t *handle,uint8_t byte,bool isF
             Log(handle,RDLC_LOG_DEBUG,"state=WaitPayloadLenH,read=%#hhX",byte);
 
             prvRxBufferFeed(handle,byte);
-            handle->payloadSize = prvRxBufferGetPayloadLen(handle);
-            handle->stateParse = RDLC_STATE_PARSE_GET_PAYLOAD;
+            if (handle->rxHeadSize == 6) {
+                handle->stateParse = RDLC_STATE_PARSE_GET_LEN2;
+                break;
+            }
+            return prvRxCheckPayloadLen(handle);
+
+        // 宽长度帧：等待载荷长度的第三个字节
+        case RDLC_STATE_PARSE_GET_LEN2:
+            Log(handle,RDLC_LOG_DEBUG,"state=WaitPayloadLen2,read=%#hhX",byte);
+            prvRxBufferFeed(handle,byte);
+            handle->stateParse = RDLC_STATE_PARSE_GET_LEN3;
         break;
 
+        // 宽长度帧：等待载荷长度的第四个字节
+        case RDLC_STATE_PARSE_GET_LEN3:
+            Log(handle,RDLC_LOG_DEBUG,"state=WaitPayloadLen3,read=%#hhX",byte);
+            prvRxBufferFeed(handle,byte);
+            return prvRxCheckPayloadLen(handle);
+
         // 等待载荷
         case RDLC_STATE_PARSE_GET_PAYLOAD:
             Log(handle,RDLC_LOG_DEBUG,"state=WaitPayload,read=%#hhX",byte);
             prvRxBufferFeed(handle,byte);
+#if RDLC_CRC16_INCREMENTAL == 1
+            handle->rxCrc = prvCrc16(handle,handle->rxCrc,&byte,1);
+#endif
 
             if (handle->rxIndexer == prvRxBufferGetCrcIndex(handle))
                 handle->stateParse = RDLC_STATE_PARSE_GET_CRCL;
@@ -480,12 +1299,7 @@ static inline int prvRxFsmParse(RdlcStaticHandle_t *handle,uint8_t byte,bool isF
             handle->stateParse = RDLC_STATE_PARSE_WAIT_HEAD;
 
             if ((crcFromBuf == crcFromFrame) && (byte == BYTE_TAIL) && (isFrame == true)) {
-                if (handle->cbParsed == NULL)
-                    Log(handle,RDLC_LOG_DEBUG,"crc pass but no callback specified");
-                else {
-                    handle->cbParsed(handle,prvRxBufferGetAddr(handle),prvRxBufferGetPayload(handle),prvRxBufferGetPayloadLen(handle));
-                    Log(handle,RDLC_LOG_DEBUG,"crc pass and callback");
-                }
+                prvRxDeliver(handle,prvRxBufferGetAddr(handle),prvRxBufferGetPayload(handle),prvRxBufferGetPayloadLen(handle));
                 prvRxBufferReset(handle);
                 return RDLC_OK;
             }
@@ -498,6 +1312,207 @@ static inline int prvRxFsmParse(RdlcStaticHandle_t *handle,uint8_t byte,bool isF
     }
     return RDLC_NOT_FINISH;
 }
+/**
+ *@brief  逐字节解析，先解转义再送入解析状态机
+ *@return 同prvRxFsmParse
+ *@addtogroup 状态机
+**/
+static inline int prvRxReadByte(RdlcStaticHandle_t *handle,uint8_t byte)
+{
+    // 仅把转义后的字符送入状态机
+    bool isFrame;
+    int realByte = prvRxFsmEscape(&(handle->stateEscape),byte,&isFrame);
+    if (realByte >= RDLC_OK)
+        return prvRxFsmParse(handle,realByte,isFrame);
+    return RDLC_NOT_FINISH;
+}
+/**
+ *@brief  零拷贝解析：帧头之后的整帧都在data中且不含转义字符时，直接把data中的载荷交给回调
+ *@param  data 帧头之后的字节
+ *@param  size 输入的字节数
+ *@return 本次消费的字节数(源地址到帧尾)，0代表不满足零拷贝条件，应交给常规流程
+ *@note   只在常规流程必然成功的情况下才走零拷贝：载荷长度不超过msgMaxSize、不会触发越界保护、帧尾正确、CRC正确，
+ *        其余情况(跨多次输入、含转义、出错)一律退回常规流程，由它给出相同的结果
+ *@addtogroup 状态机
+**/
+static inline size_t prvRxFsmZeroCopy(RdlcStaticHandle_t *handle,const uint8_t *data,size_t size)
+{
+    // 源地址 目的地址 载荷长度(2或4字节) 载荷 CRC16 0xFF 0x0C
+    size_t headSize = handle->rxHeadSize;
+    if (size < headSize + 4)
+        return 0;
+    uint32_t payloadSize = (((uint32_t)data[3])<<8) | ((uint32_t)data[2]);
+    if (headSize == 6)
+        payloadSize |= (((uint32_t)data[5])<<24) | (((uint32_t)data[4])<<16);
+    size_t frameSize = headSize + (size_t)payloadSize + 2;
+    if ((payloadSize > handle->payloadMaxSize) || (frameSize > handle->rxBufSize) ||
+        (frameSize + 2 > size) || !prvRxAccept(handle,data[1]))
+        return 0;
+    if (prvFindEscape(data,frameSize) != frameSize)
+        return 0;
+    if ((data[frameSize] != BYTE_ESCAPE) || (data[frameSize+1] != BYTE_TAIL))
+        return 0;
+
+    uint16_t crcFromFrame = (((uint16_t)data[frameSize-1])<<8) | ((uint16_t)data[frameSize-2]);
+    if (prvGetCrc16(handle,&data[headSize],payloadSize) != crcFromFrame)
+        return 0;
+
+    Log(handle,RDLC_LOG_DEBUG,"state=ZeroCopy,payload=%u",(unsigned)payloadSize);
+    RdlcAddr_t addr = {.srcAddr = data[0], .dstAddr = data[1]};
+    handle->stateParse = RDLC_STATE_PARSE_WAIT_HEAD;
+    prvRxBufferReset(handle);
+    prvRxDeliver(handle,addr,&data[headSize],payloadSize);
+    return frameSize + 2;
+}
+/**
+ *@brief  批量解析状态机，一次性消费一段不含转义字符的连续字节
+ *@param  data 输入的字节
+ *@param  size 输入的字节数
+ *@param  status 消费了字节时，写入与逐字节状态机相同的返回值
+ *@return 本次消费的字节数，0代表当前状态不适合批量处理，应交给逐字节状态机
+ *@note   只在等待帧头、等待源地址(零拷贝)和等待载荷三个状态下生效，结果与逐字节状态机完全一致：
+ *        等待帧头时，非转义字符不会改变任何状态，可以直接跳过；
+ *        等待载荷时，只有确定整段载荷不会触发越界保护时才整段拷贝，否则退回逐字节处理
+ *@addtogroup 状态机
+**/
+static inline size_t prvRxFsmSpan(RdlcStaticHandle_t *handle,const uint8_t *data,size_t size,int *status)
+{
+    size_t crcIndex;
+    size_t span;
+
+    if (handle->stateEscape != RDLC_STATE_ESCAPE_WAIT)
+        return 0;
+
+    switch(handle->stateParse)
+    {
+        // 等待帧头或跳过本帧：跳到下一个转义字符
+        case RDLC_STATE_PARSE_WAIT_HEAD:
+        case RDLC_STATE_PARSE_SKIP:
+            *status = RDLC_NOT_FINISH;
+            return prvFindEscape(data,size);
+
+        // 等待源地址：尝试零拷贝解析整帧
+        case RDLC_STATE_PARSE_GET_SRCADDR:
+            if (!(handle->flags & RDLC_FLAG_RX_ZERO_COPY) || (handle->rxIndexer != 0))
+                return 0;
+            *status = RDLC_OK;
+            return prvRxFsmZeroCopy(handle,data,size);
+
+        // 等待载荷：整段拷贝到下一个转义字符或载荷结尾
+        case RDLC_STATE_PARSE_GET_PAYLOAD:
+            crcIndex = prvRxBufferGetCrcIndex(handle);
+            if ((handle->rxIndexer < handle->rxHeadSize) || (handle->rxIndexer >= crcIndex) || (crcIndex > handle->rxBufSize))
+                return 0;
+
+            span = crcIndex - handle->rxIndexer;
+            if (span > size)
+                span = size;
+            span = prvCopyUntilEscape(&(handle->rxBuf[handle->rxIndexer]),data,span);
+            if (span == 0)
+                return 0;
+
+            Log(handle,RDLC_LOG_DEBUG,"state=WaitPayload,span=%u",(unsigned)span);
+#if RDLC_CRC16_INCREMENTAL == 1
+            handle->rxCrc = prvCrc16(handle,handle->rxCrc,&(handle->rxBuf[handle->rxIndexer]),span);
+#endif
+            handle->rxIndexer += span;
+            if (handle->rxIndexer == crcIndex)
+                handle->stateParse = RDLC_STATE_PARSE_GET_CRCL;
+            *status = RDLC_NOT_FINISH;
+            return span;
+    }
+    return 0;
+}
+/**
+ *@brief  解析一段连续的输入，某一帧出错时继续解析后面的字节
+ *@param  data 输入的字节
+ *@param  size 输入的字节数
+ *@param  error 记录第一个错误，调用前应为RDLC_OK
+ *@return 最后一个字节的解析结果，同prvRxFsmParse
+ *@addtogroup 状态机
+**/
+static int prvRxFeed(RdlcStaticHandle_t *handle,const uint8_t *data,size_t size,int *error)
+{
+    int res = RDLC_NOT_FINISH;
+    size_t i = 0;
+    while (i < size) {
+        size_t span = prvRxFsmSpan(handle,&data[i],size - i,&res);
+        if (span > 0) {
+            i += span;
+            continue;
+        }
+        res = prvRxReadByte(handle,data[i]);
+        i++;
+        if (res != RDLC_OK && res != RDLC_NOT_FINISH && *error == RDLC_OK)
+            *error = res;
+    }
+    return res;
+}
+/**
+ *@brief  分段接收的中断侧：收到帧头时占用队列中的下一个槽
+ *@return 队列满时返回RDLC_ERR_BUFFER_TOO_SHORT并丢弃这一帧
+ *@addtogroup 状态机
+**/
+static inline int prvSplitRxBegin(RdlcSplitRx_t *split)
+{
+    uint32_t head = split->head;
+    if (head - split->tailCache >= split->config.slotCount) {
+        split->tailCache = __atomic_load_n(&split->tail,__ATOMIC_ACQUIRE);
+        if (head - split->tailCache >= split->config.slotCount) {
+            split->slot = NULL;
+            split->dropped++;
+            return RDLC_ERR_BUFFER_TOO_SHORT;
+        }
+    }
+    split->slot = &split->config.slots[(size_t)(head & (split->config.slotCount - 1)) * split->config.slotSize];
+    split->fill = 2;
+    return RDLC_NOT_FINISH;
+}
+/**
+ *@brief  分段接收的中断侧：解转义并按帧头帧尾分帧，不做任何校验
+ *@return 一帧放入队列时返回RDLC_OK，丢弃时返回错误码，其余返回RDLC_NOT_FINISH
+ *@addtogroup 状态机
+**/
+static inline int prvSplitRxByte(RdlcSplitRx_t *split,uint8_t byte)
+{
+    if (split->escape == 0) {
+        if (byte == BYTE_ESCAPE) {
+            split->escape = 1;
+            return RDLC_NOT_FINISH;
+        }
+    }
+    else {
+        split->escape = 0;
+        if (byte == BYTE_HEAD)
+            return prvSplitRxBegin(split);
+        if (byte == BYTE_TAIL) {
+            if (!split->slot)
+                return RDLC_NOT_FINISH;
+            uint16_t size = split->fill - 2;
+            split->slot[0] = size & 0xFF;
+            split->slot[1] = size >> 8;
+            split->slot = NULL;
+            __atomic_store_n(&split->head,split->head + 1,__ATOMIC_RELEASE);
+            return RDLC_OK;
+        }
+        if (byte != BYTE_ESCAPE) {
+            split->slot = NULL;
+            return RDLC_ERR_NOT_ALLOWED;
+        }
+    }
+    if (!split->slot)
+        return RDLC_NOT_FINISH;
+    if (split->fill == split->config.slotSize) {
+        split->slot = NULL;
+        split->dropped++;
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+    split->slot[split->fill++] = byte;
+    // 槽内帧长2字节 源地址 目的地址：目的地址未通过过滤时不再缓存
+    if (split->fill == 4 && !prvRxAccept((RdlcStaticHandle_t*)split->protoHandle,byte))
+        split->slot = NULL;
+    return RDLC_NOT_FINISH;
+}
 /**
  * @brief 创建一个RDLC协议实例
  *
@@ -507,7 +1522,7 @@ static inline int prvRxFsmParse(RdlcStaticHandle_t *handle,uint8_t byte,bool isF
  */
 Rdlc_t xRdlcCreate(const RdlcConfig_t *config, const RdlcPort_t *port)
 {
-    if (!config || !port || !port->portMalloc || !port->portFree) {
+    if (!config || !port || !port->portMalloc || !port->portFree || !prvConfigIsValid(config)) {
         return NULL;
     }
 
@@ -515,9 +1530,11 @@ Rdlc_t xRdlcCreate(const RdlcConfig_t *config, const RdlcPort_t *port)
     if (!handle) {
         return NULL;
     }
+    prvSimdInit();
+    prvCrc16Init();
     memset(handle, 0, sizeof(RdlcStaticHandle_t));
 
-    handle->rxBufSize = prvRxBufferEstimateSize(config->msgMaxSize);
+    handle->rxBufSize = prvRxBufferEstimateSize(config->msgMaxSize,config->flags);
     handle->rxBuf = (uint8_t *)port->portMalloc(handle->rxBufSize);
     if (!handle->rxBuf) {
         port->portFree(handle);
@@ -527,10 +1544,21 @@ Rdlc_t xRdlcCreate(const RdlcConfig_t *config, const RdlcPort_t *port)
     handle->payloadMaxEscapeSize = config->msgMaxEscapeSize;
     handle->payloadMaxSize = config->msgMaxSize;
 
+    handle->flags     = config->flags;
     handle->cbParsed  = config->cbParsed;
     handle->cbError   = config->cbError;
+    handle->cbParsedWide = config->cbParsedWide;
+    handle->dispatch = config->dispatch;
+    prvRxAcceptMapInit(handle,config->addrFilter);
+    handle->rxHeadSize = 4;
     memcpy(&handle->port, port, sizeof(RdlcPort_t));
     handle->logLevel = RDLC_LOG_NONE;
+
+    if (prvFramePoolCreate(handle,config->framePoolCount) != RDLC_OK) {
+        port->portFree(handle->rxBuf);
+        port->portFree(handle);
+        return NULL;
+    }
     return (Rdlc_t)handle;
 }
 /**
@@ -545,32 +1573,41 @@ Rdlc_t xRdlcCreate(const RdlcConfig_t *config, const RdlcPort_t *port)
  * @return Rdlc_t 成功则返回实例，失败则返回NULL
  */
 Rdlc_t xRdlcCreateStatic(const RdlcConfig_t *config,const RdlcPort_t *port,
-                        RdlcStaticHandle_t* staticHandle,uint8_t *rxBuffer,uint16_t rxBufferSize)
+                        RdlcStaticHandle_t* staticHandle,uint8_t *rxBuffer,uint32_t rxBufferSize)
 {
-    if (rxBuffer == NULL)
+    if (rxBuffer == NULL || !prvConfigIsValid(config))
         return NULL;
 
-    if (prvRxBufferEstimateSize(config->msgMaxSize) > rxBufferSize) {
+    if (prvRxBufferEstimateSize(config->msgMaxSize,config->flags) > rxBufferSize) {
         return NULL;
     }
+    prvSimdInit();
+    prvCrc16Init();
     memset(staticHandle, 0, sizeof(RdlcStaticHandle_t));
     staticHandle->rxBufSize = rxBufferSize;
     staticHandle->rxBuf = rxBuffer;
     staticHandle->payloadMaxEscapeSize = config->msgMaxEscapeSize;
     staticHandle->payloadMaxSize = config->msgMaxSize;
+    staticHandle->flags     = config->flags;
     staticHandle->cbParsed  = config->cbParsed;
     staticHandle->cbError   = config->cbError;
+    staticHandle->cbParsedWide = config->cbParsedWide;
+    staticHandle->dispatch = config->dispatch;
+    prvRxAcceptMapInit(staticHandle,config->addrFilter);
+    staticHandle->rxHeadSize = 4;
     staticHandle->logLevel = RDLC_LOG_NONE;
 
     if (port == NULL) {
         staticHandle->port.portMalloc = NULL;
         staticHandle->port.portFree = NULL;
         staticHandle->port.portPrintf = NULL;
+        staticHandle->port.portCrc16 = NULL;
     }
     else{
         staticHandle->port.portPrintf = port->portPrintf;
         staticHandle->port.portFree = port->portFree;
         staticHandle->port.portMalloc = port->portMalloc;
+        staticHandle->port.portCrc16 = port->portCrc16;
     }
 
     return (Rdlc_t)staticHandle;
@@ -585,6 +1622,9 @@ void vRdlcDestroy(Rdlc_t protoHandle)
     if (!protoHandle) return;
 
     RdlcStaticHandle_t *handle = (RdlcStaticHandle_t *)protoHandle;
+    if (handle->framePool && handle->port.portFree) {
+        handle->port.portFree(handle->framePool);
+    }
     if (handle->rxBuf && handle->port.portFree) {
         handle->port.portFree(handle->rxBuf);
     }
@@ -604,12 +1644,25 @@ void vRdlcDestroy(Rdlc_t protoHandle)
  * 
  * @note 本函数将会返回一个足够大的空间，以供容纳在初始化时指定的最大报文长度。
  *       如果觉得不应该申请那么多空间，或者有静态分配空间的需求，请手动使用RDLC_GET_FRAME_SIZE宏获取帧长度
+ * @note 创建实例时指定了framePoolCount时从帧池中取帧，不清零，可以在多个线程中并发调用；帧池取空时返回RDLC_ERR_POOL_EMPTY
+ * @note 最大帧超过65535字节(宽长度帧)时size放不下，返回RDLC_ERR_NOT_ALLOWED，请用xRdlcGetFrameSize获取帧长后自行分配
  */
 int xRdlcFrameCreate(Rdlc_t protoHandle,uint8_t **frame,uint16_t *size)
 {
     RdlcStaticHandle_t *handle = (RdlcStaticHandle_t *)protoHandle;
     if (!protoHandle || !frame || !size) 
         return RDLC_ERR_INVALID_ARG;
+    if (prvTxBufferEstimateSize(handle->payloadMaxSize,handle->payloadMaxEscapeSize) > 0xFFFF)
+        return RDLC_ERR_NOT_ALLOWED;
+    if (handle->framePool != NULL) {
+        *frame = prvFramePoolTake(handle);
+        if (*frame == NULL) {
+            Log(handle,RDLC_LOG_WARN,"frame pool empty!");
+            return RDLC_ERR_POOL_EMPTY;
+        }
+        *size = prvTxBufferEstimateSize(handle->payloadMaxSize,handle->payloadMaxEscapeSize);
+        return RDLC_OK;
+    }
     if (!(handle->port.portMalloc) || !(handle->port.portFree))
         return RDLC_ERR_NOT_ALLOWED;
     
@@ -627,13 +1680,15 @@ int xRdlcFrameCreate(Rdlc_t protoHandle,uint8_t **frame,uint16_t *size)
  * @param frame 帧所在的地址，该帧必须的来源必须是动态分配的
  * 
  * @warn 此函数只对具有port->portMalloc和port->portFree的RDLC实例开放
- * @note 此函数和xRdlcFrameCreate配套
+ * @note 此函数和xRdlcFrameCreate配套，帧池中的帧归还到帧池
  */
 void vRdlcFrameDestroy(Rdlc_t protoHandle,uint8_t *frame)
 {
     RdlcStaticHandle_t *handle = (RdlcStaticHandle_t *)protoHandle;
     if (!protoHandle || !frame) 
         return;
+    if (prvFramePoolGive(handle,frame))
+        return;
     if (!(handle->port.portMalloc) || !(handle->port.portFree))
         return;
 
@@ -649,18 +1704,11 @@ void vRdlcFrameDestroy(Rdlc_t protoHandle,uint8_t *frame)
 int xRdlcReadByte(Rdlc_t protoHandle, uint8_t byte)
 {
     RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
-    int status = RDLC_NOT_FINISH;
     if (!protoHandle) {
         Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcReadByte");
         return RDLC_ERR_INVALID_ARG;
     }
-    // 仅把转义后的字符送入状态机
-    bool isFrame;
-    int realByte = prvRxFsmEscape(&(handle->stateEscape),byte,&isFrame);
-    if (realByte >= RDLC_OK){
-        status = prvRxFsmParse(handle,realByte,isFrame);
-    }
-    return status;
+    return prvRxReadByte(handle,byte);
 }
 /**
  * @brief 将多个字节送入RDLC实例中进行解析
@@ -668,108 +1716,1099 @@ int xRdlcReadByte(Rdlc_t protoHandle, uint8_t byte)
  * @param protoHandle RDLC实例
  * @param buffer 输入的字节数组
  * @param size 数组的长度
- * @return int 错误状态码
+ * @return int 错误状态码：有帧出错时返回第一个错误，否则返回最后一个字节的解析结果
+ *
+ * @note 不含转义字符的连续字节（帧间的噪声、载荷）会被整段跳过或拷贝，
+ *       其余字节仍交给逐字节状态机处理，因此结果与逐个调用xRdlcReadByte一致
+ * @note 某一帧出错(CRC错误、长度不合法、提前收到帧尾等)时继续解析buffer中剩下的字节，后面完好的帧照常交给回调
+ * @note 启用RDLC_FLAG_RX_ZERO_COPY后，完整落在buffer中且不含转义字符的帧不经过接收缓冲区，
+ *       回调拿到的载荷指针直接指向buffer，只在回调期间有效
  */
-int xRdlcReadBytes(Rdlc_t protoHandle, uint8_t *buffer, uint16_t size)
+int xRdlcReadBytes(Rdlc_t protoHandle, uint8_t *buffer, size_t size)
 {
     RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
-    int res = RDLC_NOT_FINISH;
+    int err = RDLC_OK;
     if (!protoHandle || !buffer) {
             Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcReadBytes");
             return RDLC_ERR_INVALID_ARG;
     }
-    for (uint16_t i = 0; i < size; ++i) {
-        res = xRdlcReadByte(protoHandle, buffer[i]);
-        if (res != RDLC_OK && res != RDLC_NOT_FINISH) return res;
-    }
-    return res;
+    int res = prvRxFeed(handle,buffer,size,&err);
+    return (err != RDLC_OK) ? err : res;
 }
 /**
- * @brief 对原始数据进行转义和封包
+ * @brief 初始化单生产者单消费者字节环
  *
- * @param protoHandle RDLC实例
- * @param addr 目的地址和源地址
- * @param payload 原始数据所在地址
- * @param payloadSize 原始数据长度
- * @param frameBuf 封包后的数据要放在什么位置
- * @param frameMaxSize 允许封包后的最大长度
- * @return int 封包后的RDLC数据包长度
+ * @param ring 待初始化的字节环
+ * @param buffer 存放字节的缓冲区
+ * @param size 缓冲区长度，必须是2的幂
+ * @return int 错误状态码
+ *
+ * @note 只允许一个生产者(例如串口接收中断)调用xRdlcRingPush/xRdlcRingPushByte，
+ *       一个消费者(例如解包任务)调用xRdlcRingPeek/vRdlcRingConsume/xRdlcRingDrain，两端之间不需要加锁或关中断
  */
-int xRdlcWriteBytes(Rdlc_t protoHandle,RdlcAddr_t addr,
-                    const uint8_t *payload,uint16_t payloadSize,
-                    uint8_t *frameBuf,uint16_t frameMaxSize)
+int xRdlcRingInit(RdlcRing_t *ring,uint8_t *buffer,uint32_t size)
 {
-    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
-    int err;
-
-    if (!protoHandle || !payload || !frameBuf) {
-        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcWriteBytes");
+    if (!ring || !buffer || size < 2 || (size & (size - 1)))
         return RDLC_ERR_INVALID_ARG;
-    }
-    if ((frameMaxSize < prvTxBufferEstimateSize(handle->payloadMaxSize,handle->payloadMaxEscapeSize))||
-        (payloadSize > handle->payloadMaxSize)) {
-        Log(handle,RDLC_LOG_ERR,"frame buffer too short.expect %hd but %hd",prvTxBufferEstimateSize(handle->payloadMaxSize,handle->payloadMaxEscapeSize),frameMaxSize);
-        return RDLC_ERR_BUFFER_TOO_SHORT;
-    }
-
-    uint16_t itr = 0;
-    uint16_t crc16 = prvGetCrc16(payload,payloadSize);
-
-    err = prvTxBufferFeedHead(handle,addr,frameBuf,frameMaxSize,&itr,payloadSize,0x0);
-    if (err != RDLC_OK) return err;
-
-    err = prvTxBufferFeedPayload(handle,frameBuf,frameMaxSize,&itr,(uint8_t*)payload,payloadSize);
-    if (err != RDLC_OK) return err;
-
-    err = prvTxBufferFeedTail(handle,frameBuf,frameMaxSize,&itr,crc16);
-    if (err != RDLC_OK) return err;
-
-
-    return itr;
+    memset(ring,0,sizeof(RdlcRing_t));
+    ring->buffer = buffer;
+    ring->mask = size - 1;
+    return RDLC_OK;
 }
 /**
- * @brief 复位RDLC实例的接收状态
+ * @brief 生产者向字节环写入一个字节，适合在每收到一个字节就触发一次的中断中调用
  *
- * @param protoHandle RDLC实例
- * @return int 错误状态码
+ * @param ring 字节环
+ * @param byte 写入的字节
+ * @return int 错误状态码，写满时返回RDLC_ERR_BUFFER_TOO_SHORT并丢弃该字节
  */
-void vRdlcReset(Rdlc_t protoHandle)
+int xRdlcRingPushByte(RdlcRing_t *ring,uint8_t byte)
 {
-    if (!protoHandle) return;
-    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
-
-    memset(handle->rxBuf,0,handle->rxBufSize);
-    handle->payloadSize = 0;
-    handle->rxIndexer = 0;
-    handle->stateEscape = 0;
-    handle->stateParse = RDLC_STATE_PARSE_WAIT_HEAD;
-    handle->stateEscape = RDLC_STATE_ESCAPE_WAIT;
+    if (!ring)
+        return RDLC_ERR_INVALID_ARG;
+    uint32_t head = ring->head;
+    if (head - ring->tailCache > ring->mask) {
+        ring->tailCache = __atomic_load_n(&ring->tail,__ATOMIC_ACQUIRE);
+        if (head - ring->tailCache > ring->mask) {
+            ring->dropped++;
+            return RDLC_ERR_BUFFER_TOO_SHORT;
+        }
+    }
+    ring->buffer[head & ring->mask] = byte;
+    __atomic_store_n(&ring->head,head + 1,__ATOMIC_RELEASE);
+    return RDLC_OK;
 }
 /**
- * @brief 获取RDLC实例的内部解析状态
+ * @brief 生产者向字节环写入多个字节，适合在DMA半满/全满或空闲中断中调用
  *
- * @param protoHandle RDLC实例
- * @return int 解析状态机状态
+ * @param ring 字节环
+ * @param data 写入的数据
+ * @param size 数据长度
+ * @return uint32_t 实际写入的字节数，写满时其余字节被丢弃并计入dropped
  */
-int xRdlcGetParseState(Rdlc_t protoHandle)
+uint32_t xRdlcRingPush(RdlcRing_t *ring,const uint8_t *data,uint32_t size)
 {
-    if (!protoHandle) return RDLC_ERR_NOT_ALLOWED;
-    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
-    return handle->stateParse;
-    return 0;
+    if (!ring || !data)
+        return 0;
+    uint32_t head = ring->head;
+    uint32_t capacity = ring->mask + 1;
+    uint32_t space = capacity - (head - ring->tailCache);
+    if (space < size) {
+        ring->tailCache = __atomic_load_n(&ring->tail,__ATOMIC_ACQUIRE);
+        space = capacity - (head - ring->tailCache);
+    }
+    uint32_t count = (size < space) ? size : space;
+    uint32_t offset = head & ring->mask;
+    uint32_t first = capacity - offset;
+    if (first > count)
+        first = count;
+    memcpy(&ring->buffer[offset],data,first);
+    memcpy(ring->buffer,&data[first],count - first);
+    __atomic_store_n(&ring->head,head + count,__ATOMIC_RELEASE);
+    ring->dropped += size - count;
+    return count;
 }
 /**
- * @brief 获取RDLC实例的内部转义状态
+ * @brief 消费者查看字节环中连续可读的数据
  *
- * @param protoHandle RDLC实例
- * @return int 解析状态机状态
+ * @param ring 字节环
+ * @param data 输出连续数据的起始地址
+ * @return uint32_t 连续可读的字节数；数据跨过缓冲区末尾时只返回末尾之前的部分，消费后再次调用得到其余部分
  */
-int xRdlcGetEscapeState(Rdlc_t protoHandle)
+uint32_t xRdlcRingPeek(RdlcRing_t *ring,const uint8_t **data)
 {
-    if (!protoHandle) return RDLC_ERR_NOT_ALLOWED;
-    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
-    return handle->stateEscape;
-    return 0;
+    if (!ring || !data)
+        return 0;
+    uint32_t tail = ring->tail;
+    if (ring->headCache == tail)
+        ring->headCache = __atomic_load_n(&ring->head,__ATOMIC_ACQUIRE);
+    uint32_t count = ring->headCache - tail;
+    uint32_t offset = tail & ring->mask;
+    if (count > ring->mask + 1 - offset)
+        count = ring->mask + 1 - offset;
+    *data = &ring->buffer[offset];
+    return count;
+}
+/**
+ * @brief 消费者归还已经处理完的数据
+ *
+ * @param ring 字节环
+ * @param size 归还的字节数，不能超过xRdlcRingPeek返回的长度
+ */
+void vRdlcRingConsume(RdlcRing_t *ring,uint32_t size)
+{
+    if (!ring)
+        return;
+    __atomic_store_n(&ring->tail,ring->tail + size,__ATOMIC_RELEASE);
+}
+/**
+ * @brief 消费者把字节环中已有的数据全部送入RDLC实例中解析
+ *
+ * @param protoHandle RDLC实例
+ * @param ring 字节环
+ * @return int 错误状态码，某一帧出错时返回第一个错误，但后面的数据仍会被解析；没有数据时返回RDLC_NOT_FINISH
+ *
+ * @note 数据在环中原地解析，最多分两段(缓冲区末尾之前和之后)，不经过额外拷贝；
+ *       启用RDLC_FLAG_RX_ZERO_COPY时，完整落在同一段中的帧会直接把环中的载荷交给回调
+ */
+int xRdlcRingDrain(Rdlc_t protoHandle,RdlcRing_t *ring)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !ring) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcRingDrain");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    int res = RDLC_NOT_FINISH;
+    int err = RDLC_OK;
+    const uint8_t *data;
+    uint32_t size;
+    for (int part = 0; part < 2 && (size = xRdlcRingPeek(ring,&data)) > 0; part++) {
+        res = prvRxFeed(handle,data,size,&err);
+        vRdlcRingConsume(ring,size);
+    }
+    return (err != RDLC_OK) ? err : res;
+}
+/**
+ * @brief 初始化循环DMA接收器
+ *
+ * @param protoHandle 解包用的RDLC实例
+ * @param dma 待初始化的接收器
+ * @param buffer 循环模式DMA的目标缓冲区
+ * @param size 缓冲区长度
+ * @return int 错误状态码
+ *
+ * @note 初始化时认为DMA从buffer[0]开始写入，应在启动DMA之前或之后立即调用
+ */
+int xRdlcDmaRxInit(Rdlc_t protoHandle,RdlcDmaRx_t *dma,uint8_t *buffer,uint32_t size)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !dma || !buffer || size == 0) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcDmaRxInit");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    dma->protoHandle = protoHandle;
+    dma->buffer = buffer;
+    dma->size = size;
+    dma->readIndex = 0;
+    return RDLC_OK;
+}
+/**
+ * @brief 把循环DMA缓冲区中新写入的数据送入RDLC实例中解析
+ *
+ * @param dma 接收器
+ * @param writeIndex DMA的当前写入位置，例如STM32上为size - __HAL_DMA_GET_COUNTER()，取size等同于0
+ * @return int 错误状态码，某一帧出错时返回第一个错误，但后面的数据仍会被解析；没有新数据时返回RDLC_NOT_FINISH
+ *
+ * @note 在半满、全满和空闲中断中调用即可，新数据跨过缓冲区末尾时分两段在DMA缓冲区中原地解析，不经过额外拷贝
+ * @note 只能根据写入位置判断新数据，两次调用之间DMA写入的数据不能达到size字节，否则会被当作没有新数据或丢失一整圈；
+ *       半满和全满中断保证了这一点，前提是中断能在DMA写完下半个缓冲区之前得到处理
+ */
+int xRdlcDmaRxUpdate(RdlcDmaRx_t *dma,uint32_t writeIndex)
+{
+    if (!dma || !dma->protoHandle || writeIndex > dma->size)
+        return RDLC_ERR_INVALID_ARG;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)dma->protoHandle;
+    int res = RDLC_NOT_FINISH;
+    int err = RDLC_OK;
+    if (writeIndex == dma->size)
+        writeIndex = 0;
+    if (writeIndex < dma->readIndex) {
+        res = prvRxFeed(handle,&dma->buffer[dma->readIndex],dma->size - dma->readIndex,&err);
+        dma->readIndex = 0;
+    }
+    if (writeIndex > dma->readIndex) {
+        res = prvRxFeed(handle,&dma->buffer[dma->readIndex],writeIndex - dma->readIndex,&err);
+        dma->readIndex = writeIndex;
+    }
+    return (err != RDLC_OK) ? err : res;
+}
+/**
+ * @brief 初始化分段接收器
+ *
+ * @param protoHandle 校验和回调使用的RDLC实例
+ * @param split 待初始化的分段接收器
+ * @param config 配置，槽缓冲区由调用者提供
+ * @return int 错误状态码
+ *
+ * @note 中断中只调用xRdlcSplitRxIsrByte/xRdlcSplitRxIsrBytes，每字节只做解转义、判断帧头帧尾和一次存储，
+ *       任务中调用xRdlcSplitRxPoll校验CRC并执行回调；两端无锁，不需要关中断
+ * @note 只接收普通帧，宽长度帧被忽略；帧内出现帧头时放弃当前帧，从新的帧头重新开始
+ */
+int xRdlcSplitRxInit(Rdlc_t protoHandle,RdlcSplitRx_t *split,const RdlcSplitRxConfig_t *config)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !split || !config || !config->slots || config->slotSize < RDLC_SPLIT_SLOT_SIZE(1) ||
+        config->slotCount == 0 || (config->slotCount & (config->slotCount - 1))) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcSplitRxInit");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    memset(split,0,sizeof(RdlcSplitRx_t));
+    split->protoHandle = protoHandle;
+    split->config = *config;
+    return RDLC_OK;
+}
+/**
+ * @brief 分段接收的中断侧：送入一个字节
+ *
+ * @param split 分段接收器
+ * @param byte 输入的字节
+ * @return int 一帧放入队列时返回RDLC_OK，队列满或帧超过slotSize时返回RDLC_ERR_BUFFER_TOO_SHORT，其余返回RDLC_NOT_FINISH
+ */
+int xRdlcSplitRxIsrByte(RdlcSplitRx_t *split,uint8_t byte)
+{
+    if (!split)
+        return RDLC_ERR_INVALID_ARG;
+    return prvSplitRxByte(split,byte);
+}
+/**
+ * @brief 分段接收的中断侧：送入多个字节，适合DMA中断
+ *
+ * @param split 分段接收器
+ * @param buffer 输入的字节数组
+ * @param size 数组的长度
+ * @return int 有帧被丢弃时返回第一个错误，否则至少一帧放入队列时返回RDLC_OK，其余返回RDLC_NOT_FINISH
+ */
+int xRdlcSplitRxIsrBytes(RdlcSplitRx_t *split,const uint8_t *buffer,size_t size)
+{
+    if (!split || !buffer)
+        return RDLC_ERR_INVALID_ARG;
+    int res = RDLC_NOT_FINISH;
+    int err = RDLC_OK;
+    for (size_t i = 0; i < size; i++) {
+        int r = prvSplitRxByte(split,buffer[i]);
+        if (r == RDLC_OK)
+            res = RDLC_OK;
+        else if (r != RDLC_NOT_FINISH && err == RDLC_OK)
+            err = r;
+    }
+    return (err != RDLC_OK) ? err : res;
+}
+/**
+ * @brief 分段接收的任务侧：校验队列中的帧并执行回调
+ *
+ * @param split 分段接收器
+ * @return int 错误状态码，某一帧校验失败时返回第一个错误，但后面的帧仍会被处理；队列为空时返回RDLC_NOT_FINISH
+ *
+ * @note 回调拿到的载荷指针指向队列中的槽，只在回调期间有效
+ */
+int xRdlcSplitRxPoll(RdlcSplitRx_t *split)
+{
+    if (!split || !split->protoHandle)
+        return RDLC_ERR_INVALID_ARG;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)split->protoHandle;
+    int res = RDLC_NOT_FINISH;
+    int err = RDLC_OK;
+    uint32_t head = __atomic_load_n(&split->head,__ATOMIC_ACQUIRE);
+    while (split->tail != head) {
+        const uint8_t *slot = &split->config.slots[(size_t)(split->tail & (split->config.slotCount - 1)) * split->config.slotSize];
+        // 槽内帧长 源地址 目的地址 载荷长度 载荷 CRC16
+        uint32_t size = ((uint32_t)slot[1] << 8) | slot[0];
+        const uint8_t *frame = &slot[2];
+        uint32_t payloadSize = (size >= 6) ? (((uint32_t)frame[3] << 8) | frame[2]) : 0;
+        if ((size >= 6) && (payloadSize + 6 == size) && (payloadSize <= handle->payloadMaxSize) &&
+            (prvGetCrc16(handle,&frame[4],payloadSize) == (((uint16_t)frame[size-1] << 8) | frame[size-2]))) {
+            RdlcAddr_t addr = {.srcAddr = frame[0], .dstAddr = frame[1]};
+            prvRxDeliver(handle,addr,&frame[4],payloadSize);
+            res = RDLC_OK;
+        }
+        else {
+            Log(handle,RDLC_LOG_WARN,"split frame of %u bytes failed length or crc check",(unsigned)size);
+            if (err == RDLC_OK)
+                err = RDLC_ERR_CRC;
+        }
+        __atomic_store_n(&split->tail,split->tail + 1,__ATOMIC_RELEASE);
+    }
+    return (err != RDLC_OK) ? err : res;
+}
+/**
+ * @brief 对原始数据进行转义和封包
+ *
+ * @param protoHandle RDLC实例
+ * @param addr 目的地址和源地址
+ * @param payload 原始数据所在地址
+ * @param payloadSize 原始数据长度
+ * @param frameBuf 封包后的数据要放在什么位置
+ * @param frameMaxSize 允许封包后的最大长度
+ * @return int 封包后的RDLC数据包长度
+ *
+ * @note frameMaxSize不必按最坏情况预留，只要不小于xRdlcGetFrameSize的结果即可，放不下时返回RDLC_ERR_BUFFER_TOO_SHORT
+ */
+int xRdlcWriteBytes(Rdlc_t protoHandle,RdlcAddr_t addr,
+                    const uint8_t *payload,size_t payloadSize,
+                    uint8_t *frameBuf,size_t frameMaxSize)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+
+    if (!protoHandle || !payload || !frameBuf) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcWriteBytes");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    if (payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_ERR,"payload too long.expect %u but %u",(unsigned)handle->payloadMaxSize,(unsigned)payloadSize);
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    // RdlcFragment_t的长度只有16位，宽长度帧的载荷直接整段写入
+    size_t itr = 0;
+    uint16_t crc16 = RDLC_CRC16_INIT;
+    int err;
+    err = prvTxBufferFeedHead(handle,addr,frameBuf,frameMaxSize,&itr,payloadSize,0x0);
+    if (err != RDLC_OK) return err;
+    err = prvTxBufferFeedPayload(handle,frameBuf,frameMaxSize,&itr,payload,payloadSize,&crc16);
+    if (err != RDLC_OK) return err;
+    err = prvTxBufferFeedTail(handle,frameBuf,frameMaxSize,&itr,crc16);
+    if (err != RDLC_OK) return err;
+    return (int)itr;
+}
+/**
+ * @brief 把多段原始数据拼成一个载荷，进行转义和封包
+ *
+ * @param protoHandle RDLC实例
+ * @param addr 目的地址和源地址
+ * @param fragments 载荷片段数组，按顺序拼接；长度为0的片段data可以为NULL
+ * @param fragmentCount 片段个数
+ * @param frameBuf 封包后的数据要放在什么位置
+ * @param frameMaxSize 允许封包后的最大长度
+ * @return int 封包后的RDLC数据包长度
+ *
+ * @note 结果与先把片段拼接到临时缓冲区再调用xRdlcWriteBytes完全相同，CRC跨片段连续累计
+ */
+int xRdlcWriteFragments(Rdlc_t protoHandle,RdlcAddr_t addr,
+                        const RdlcFragment_t *fragments,uint16_t fragmentCount,
+                        uint8_t *frameBuf,size_t frameMaxSize)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+
+    if (!protoHandle || (!fragments && fragmentCount) || !frameBuf) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcWriteFragments");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    size_t payloadSize = 0;
+    for (uint16_t i = 0; i < fragmentCount; i++) {
+        if (!fragments[i].data && fragments[i].size) {
+            Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcWriteFragments");
+            return RDLC_ERR_INVALID_ARG;
+        }
+        payloadSize += fragments[i].size;
+    }
+    if (payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_ERR,"payload too long.expect %u but %u",(unsigned)handle->payloadMaxSize,(unsigned)payloadSize);
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    return prvTxEncode(handle,addr,fragments,fragmentCount,payloadSize,frameBuf,frameMaxSize);
+}
+/**
+ * @brief 零拷贝封包：输出一组片段，载荷中不需转义的连续字节直接引用payload，可直接交给writev()
+ *
+ * @param protoHandle RDLC实例
+ * @param addr 目的地址和源地址
+ * @param payload 原始数据所在地址
+ * @param payloadSize 原始数据长度
+ * @param iov 输出的片段数组，按顺序发送即为完整的帧
+ * @param iovMaxCount 片段数组的容量，至少为载荷中0xFF的个数加3
+ * @param scratch 存放帧头和帧尾的暂存区，至少RDLC_IOV_SCRATCH_SIZE字节
+ * @param scratchSize 暂存区的大小
+ * @return int 使用的片段个数，出错时返回错误码
+ *
+ * @note 载荷中的0xFF不另外占用暂存区：前一个片段以这个0xFF结尾，后一个片段又从它开始，相邻片段重叠一个字节即完成转义
+ * @note 片段引用payload和scratch，发送完成之前两者都不能被修改或释放
+ */
+int xRdlcWriteIovec(Rdlc_t protoHandle,RdlcAddr_t addr,
+                    const uint8_t *payload,uint16_t payloadSize,
+                    RdlcFragment_t *iov,uint16_t iovMaxCount,
+                    uint8_t *scratch,uint16_t scratchSize)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    int err;
+
+    if (!protoHandle || !payload || !iov || !scratch) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcWriteIovec");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    if (payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_ERR,"payload too long.expect %u but %u",(unsigned)handle->payloadMaxSize,(unsigned)payloadSize);
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    // 帧头
+    size_t itr = 0;
+    uint16_t count = 0;
+    err = prvTxBufferFeedHead(handle,addr,scratch,scratchSize,&itr,payloadSize,0x0);
+    if (err != RDLC_OK) return err;
+    err = prvTxIovPush(handle,iov,iovMaxCount,&count,scratch,itr);
+    if (err != RDLC_OK) return err;
+
+    // 载荷：每遇到一个0xFF就截断，下一个片段从这个0xFF重新开始
+    uint16_t start = 0;
+    uint16_t pos = 0;
+    while (pos < payloadSize) {
+        pos += prvFindEscape(&payload[pos],payloadSize - pos);
+        bool escaped = (pos < payloadSize);
+        if (escaped)
+            pos++;
+        err = prvTxIovPush(handle,iov,iovMaxCount,&count,&payload[start],pos - start);
+        if (err != RDLC_OK) return err;
+        start = escaped ? (pos - 1) : pos;
+    }
+    if (start < payloadSize) {
+        err = prvTxIovPush(handle,iov,iovMaxCount,&count,&payload[start],payloadSize - start);
+        if (err != RDLC_OK) return err;
+    }
+
+    // 帧尾
+    uint16_t crc16 = RDLC_CRC16_INIT;
+    size_t block;
+    for (size_t base = 0; base < payloadSize; base += block) {
+        block = payloadSize - base;
+        if (block > RDLC_TX_BLOCK_SIZE)
+            block = RDLC_TX_BLOCK_SIZE;
+        crc16 = prvCrc16(handle,crc16,&payload[base],block);
+    }
+    size_t tail = itr;
+    err = prvTxBufferFeedTail(handle,scratch,scratchSize,&itr,crc16);
+    if (err != RDLC_OK) return err;
+    err = prvTxIovPush(handle,iov,iovMaxCount,&count,&scratch[tail],itr - tail);
+    if (err != RDLC_OK) return err;
+    return count;
+}
+/**
+ * @brief 原地封包：载荷已经放在buffer[headroom]处，直接在buffer中转义，帧头写入前面预留的空间，CRC和帧尾写入后面预留的空间
+ *
+ * @param protoHandle RDLC实例
+ * @param addr 目的地址和源地址
+ * @param buffer 调用者的缓冲区，载荷从buffer[headroom]开始
+ * @param bufferSize 缓冲区的总长度，载荷之后至少要留出(载荷中0xFF的个数 + 6)字节
+ * @param headroom 载荷之前预留的长度，不小于RDLC_INPLACE_HEADROOM即可保证放得下帧头
+ * @param payloadSize 原始数据长度
+ * @param frame 输出帧的起始地址，位于buffer之内
+ * @return int 封包后的长度，或错误码
+ *
+ * @note 空间不够时返回RDLC_ERR_BUFFER_TOO_SHORT，此时buffer中的载荷保持不变；成功后载荷被转义后的数据覆盖
+ */
+int xRdlcWriteInPlace(Rdlc_t protoHandle,RdlcAddr_t addr,
+                      uint8_t *buffer,uint16_t bufferSize,
+                      uint16_t headroom,uint16_t payloadSize,
+                      uint8_t **frame)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    int err;
+
+    if (!protoHandle || !buffer || !frame || ((size_t)headroom + payloadSize > bufferSize)) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcWriteInPlace");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    if (payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_ERR,"payload too long.expect %u but %u",(unsigned)handle->payloadMaxSize,(unsigned)payloadSize);
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    // 先在原始载荷上统计转义字符和计算CRC，再确认空间足够，之后才修改buffer
+    uint8_t *payload = &buffer[headroom];
+    size_t escapeCount = 0;
+    uint16_t crc16 = RDLC_CRC16_INIT;
+    size_t block;
+    for (size_t base = 0; base < payloadSize; base += block) {
+        block = payloadSize - base;
+        if (block > RDLC_TX_BLOCK_SIZE)
+            block = RDLC_TX_BLOCK_SIZE;
+        escapeCount += prvCountEscape(&payload[base],block);
+        crc16 = prvCrc16(handle,crc16,&payload[base],block);
+    }
+
+    uint8_t head[RDLC_INPLACE_HEADROOM];
+    uint8_t tail[6];
+    size_t headSize = 0;
+    size_t tailSize = 0;
+    err = prvTxBufferFeedHead(handle,addr,head,sizeof(head),&headSize,payloadSize,0x0);
+    if (err != RDLC_OK) return err;
+    err = prvTxBufferFeedTail(handle,tail,sizeof(tail),&tailSize,crc16);
+    if (err != RDLC_OK) return err;
+
+    size_t escapedSize = payloadSize + escapeCount;
+    if ((headSize > headroom) || ((size_t)headroom + escapedSize + tailSize > bufferSize)) {
+        Log(handle,RDLC_LOG_ERR,"InPlace buffer too short!");
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    prvTxEscapeBackward(payload,payloadSize,escapeCount);
+    memcpy(&payload[escapedSize],tail,tailSize);
+    memcpy(payload - headSize,head,headSize);
+
+    *frame = payload - headSize;
+    return (int)(headSize + escapedSize + tailSize);
+}
+/**
+ * @brief 初始化流式封包器，之后用xRdlcEncoderPull分块取出封包后的数据
+ *
+ * @param protoHandle RDLC实例
+ * @param encoder 封包器，由调用者分配
+ * @param addr 目的地址和源地址
+ * @param payload 原始数据所在地址，整帧取完之前不能被修改或释放
+ * @param payloadSize 原始数据长度
+ * @return int 错误状态码
+ */
+int xRdlcEncoderInit(Rdlc_t protoHandle,RdlcEncoder_t *encoder,RdlcAddr_t addr,
+                     const uint8_t *payload,uint16_t payloadSize)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !encoder || !payload) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcEncoderInit");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    if (payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_ERR,"payload too long.expect %u but %u",(unsigned)handle->payloadMaxSize,(unsigned)payloadSize);
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    memset(encoder,0,sizeof(RdlcEncoder_t));
+    encoder->protoHandle = protoHandle;
+    encoder->payload = payload;
+    encoder->payloadSize = payloadSize;
+    encoder->crc = RDLC_CRC16_INIT;
+    encoder->stateEncode = RDLC_STATE_ENCODE_HEAD;
+
+    size_t itr = 0;
+    int err = prvTxBufferFeedHead(handle,addr,encoder->frame,sizeof(encoder->frame),&itr,payloadSize,0x0);
+    if (err != RDLC_OK) return err;
+    encoder->frameSize = itr;
+    return RDLC_OK;
+}
+/**
+ * @brief 从流式封包器中取出下一块封包后的数据
+ *
+ * @param encoder 已初始化的封包器
+ * @param buffer 输出缓冲区，例如一块DMA发送缓冲区
+ * @param size 输出缓冲区的长度，可以为任意正数
+ * @return int 本次写入的字节数，0代表整帧已经取完，负数为错误码
+ *
+ * @note 依次取出的数据拼接起来与xRdlcWriteBytes的结果完全相同；CRC随载荷逐块累计，
+ *       转义对跨越块边界时，后一个0xFF会在下一次调用时输出
+ */
+int xRdlcEncoderPull(RdlcEncoder_t *encoder,uint8_t *buffer,uint16_t size)
+{
+    if (!encoder || !encoder->protoHandle || !buffer)
+        return RDLC_ERR_INVALID_ARG;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)encoder->protoHandle;
+    uint16_t out = 0;
+    uint16_t begin;
+    size_t limit;
+    size_t span;
+    size_t itr;
+    int err;
+
+    while ((out < size) && (encoder->stateEncode != RDLC_STATE_ENCODE_DONE)) {
+        switch (encoder->stateEncode)
+        {
+            // 帧头和帧尾：从转义好的暂存区拷贝
+            case RDLC_STATE_ENCODE_HEAD:
+            case RDLC_STATE_ENCODE_TAIL:
+                span = encoder->frameSize - encoder->frameIndexer;
+                if (span > (size_t)(size - out))
+                    span = size - out;
+                memcpy(&buffer[out],&encoder->frame[encoder->frameIndexer],span);
+                out += span;
+                encoder->frameIndexer += span;
+                if (encoder->frameIndexer == encoder->frameSize)
+                    encoder->stateEncode = (encoder->stateEncode == RDLC_STATE_ENCODE_HEAD) ? RDLC_STATE_ENCODE_PAYLOAD : RDLC_STATE_ENCODE_DONE;
+            break;
+
+            // 载荷：整段拷贝不含转义字符的连续字节，结束时累计本次输出的载荷的CRC
+            case RDLC_STATE_ENCODE_PAYLOAD:
+                begin = encoder->payloadIndexer;
+                while ((out < size) && ((encoder->payloadIndexer < encoder->payloadSize) || encoder->escapePending)) {
+                    if (encoder->escapePending) {
+                        buffer[out++] = BYTE_ESCAPE;
+                        encoder->escapePending = 0;
+                        continue;
+                    }
+                    limit = encoder->payloadSize - encoder->payloadIndexer;
+                    if (limit > (size_t)(size - out))
+                        limit = size - out;
+                    span = prvCopyUntilEscape(&buffer[out],&encoder->payload[encoder->payloadIndexer],limit);
+                    out += span;
+                    encoder->payloadIndexer += span;
+                    if (span < limit) {
+                        buffer[out++] = BYTE_ESCAPE;
+                        encoder->payloadIndexer++;
+                        encoder->escapePending = 1;
+                    }
+                }
+                encoder->crc = prvCrc16(handle,encoder->crc,&encoder->payload[begin],encoder->payloadIndexer - begin);
+
+                if ((encoder->payloadIndexer == encoder->payloadSize) && !encoder->escapePending) {
+                    itr = 0;
+                    err = prvTxBufferFeedTail(handle,encoder->frame,sizeof(encoder->frame),&itr,encoder->crc);
+                    if (err != RDLC_OK) return err;
+                    encoder->frameSize = itr;
+                    encoder->frameIndexer = 0;
+                    encoder->stateEncode = RDLC_STATE_ENCODE_TAIL;
+                }
+            break;
+        }
+    }
+    return out;
+}
+/**
+ * @brief 初始化批量封包器，把多帧依次封包到同一个缓冲区中，攒够一批再一次性输出
+ *
+ * @param protoHandle RDLC实例
+ * @param batch 批量封包器，由调用者分配
+ * @param config 批量封包的配置，其中的缓冲区要确保生命周期不短于batch
+ * @return int 错误状态码
+ */
+int xRdlcBatchInit(Rdlc_t protoHandle,RdlcBatch_t *batch,const RdlcBatchConfig_t *config)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !batch || !config || !config->buffer || !config->cbFlush ||
+        (config->offsets && !config->offsetsMax)) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcBatchInit");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    memset(batch,0,sizeof(RdlcBatch_t));
+    batch->protoHandle = protoHandle;
+    memcpy(&batch->config,config,sizeof(RdlcBatchConfig_t));
+    return RDLC_OK;
+}
+/**
+ * @brief 立即输出批量封包器中已有的帧
+ *
+ * @param batch 批量封包器
+ * @return int 缓冲区为空时返回RDLC_OK，否则返回cbFlush的返回值
+ */
+int xRdlcBatchFlush(RdlcBatch_t *batch)
+{
+    if (!batch || !batch->protoHandle)
+        return RDLC_ERR_INVALID_ARG;
+    if (batch->count == 0)
+        return RDLC_OK;
+
+    RdlcBatchConfig_t *config = &batch->config;
+    int res = config->cbFlush(batch->protoHandle,config->buffer,batch->used,config->offsets,batch->count);
+    batch->used = 0;
+    batch->count = 0;
+    return res;
+}
+/**
+ * @brief 封包一帧并追加到批量封包器中
+ *
+ * @param batch 批量封包器
+ * @param addr 目的地址和源地址
+ * @param payload 原始数据所在地址
+ * @param payloadSize 原始数据长度
+ * @param nowTick 当前时刻，只用于flushTicks判断，单位由调用者决定
+ * @return int 这一帧在本批中的序号，出错时返回错误码
+ *
+ * @note 缓冲区或偏移数组放不下时先输出已有的帧再封包；累计长度达到flushSize时封包后立即输出，
+ *       此时返回的序号对应刚刚输出的那一批
+ * @note cbFlush返回负数时原样返回它，不返回序号：这一批的帧已经丢弃，需要时由调用者重发。
+ *       封包前的输出失败时，这一帧不会进入批量封包器
+ */
+int xRdlcBatchAppend(RdlcBatch_t *batch,RdlcAddr_t addr,const uint8_t *payload,uint16_t payloadSize,uint32_t nowTick)
+{
+    if (!batch || !batch->protoHandle || !payload)
+        return RDLC_ERR_INVALID_ARG;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)batch->protoHandle;
+    RdlcBatchConfig_t *config = &batch->config;
+    if (payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_ERR,"payload too long.expect %u but %u",(unsigned)handle->payloadMaxSize,(unsigned)payloadSize);
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    int res;
+    if (config->offsetsMax && (batch->count == config->offsetsMax)) {
+        res = xRdlcBatchFlush(batch);
+        if (res < 0)
+            return res;
+    }
+
+    RdlcFragment_t fragment = {.data = payload, .size = payloadSize};
+    int len = prvTxEncode(handle,addr,&fragment,1,payloadSize,&config->buffer[batch->used],config->bufferSize - batch->used);
+    if ((len == RDLC_ERR_BUFFER_TOO_SHORT) && (batch->count > 0)) {
+        res = xRdlcBatchFlush(batch);
+        if (res < 0)
+            return res;
+        len = prvTxEncode(handle,addr,&fragment,1,payloadSize,config->buffer,config->bufferSize);
+    }
+    if (len < 0)
+        return len;
+
+    if (batch->count == 0)
+        batch->firstTick = nowTick;
+    if (config->offsets)
+        config->offsets[batch->count] = batch->used;
+    int index = batch->count;
+    batch->used += len;
+    batch->count++;
+
+    if (config->flushSize && (batch->used >= config->flushSize))
+        res = xRdlcBatchFlush(batch);
+    else
+        res = xRdlcBatchPoll(batch,nowTick);
+    if (res < 0)
+        return res;
+    return index;
+}
+/**
+ * @brief 检查批量封包器是否到了按时间输出的时刻，应在发送线程中周期性调用
+ *
+ * @param batch 批量封包器
+ * @param nowTick 当前时刻，与xRdlcBatchAppend使用同一个时钟，允许回绕
+ * @return int 没有输出时返回RDLC_OK，否则返回cbFlush的返回值
+ */
+int xRdlcBatchPoll(RdlcBatch_t *batch,uint32_t nowTick)
+{
+    if (!batch || !batch->protoHandle)
+        return RDLC_ERR_INVALID_ARG;
+    if ((batch->count == 0) || (batch->config.flushTicks == 0))
+        return RDLC_OK;
+    if ((uint32_t)(nowTick - batch->firstTick) < batch->config.flushTicks)
+        return RDLC_OK;
+    return xRdlcBatchFlush(batch);
+}
+/**
+ * @brief 初始化分片发送器，把一条可能超过msgMaxSize的消息拆成若干帧，之后用xRdlcFragmenterNext逐帧取出
+ *
+ * @param protoHandle RDLC实例
+ * @param fragmenter 分片发送器，由调用者分配
+ * @param addr 目的地址和源地址
+ * @param msgId 消息号，接收方用它区分前后两条消息，建议每条消息递增
+ * @param message 消息所在地址，全部分片取完之前不能被修改或释放；messageSize为0时可以为NULL
+ * @param messageSize 消息长度
+ * @return int 分片个数，出错时返回错误码
+ *
+ * @note 每帧的载荷是RDLC_FRAGMENT_HEADER_SIZE字节的分片头加上最多msgMaxSize - RDLC_FRAGMENT_HEADER_SIZE字节的消息，
+ *       分片数不能超过65535
+ */
+int xRdlcFragmenterInit(Rdlc_t protoHandle,RdlcFragmenter_t *fragmenter,RdlcAddr_t addr,uint8_t msgId,
+                        const uint8_t *message,size_t messageSize)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !fragmenter || (!message && messageSize) || (messageSize > UINT32_MAX) ||
+        (handle->payloadMaxSize <= RDLC_FRAGMENT_HEADER_SIZE)) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcFragmenterInit");
+        return RDLC_ERR_INVALID_ARG;
+    }
+
+    size_t fragmentSize = handle->payloadMaxSize - RDLC_FRAGMENT_HEADER_SIZE;
+    if (fragmentSize > 0xFFFF)
+        fragmentSize = 0xFFFF;
+    size_t count = (messageSize + fragmentSize - 1) / fragmentSize;
+    if (count == 0)
+        count = 1;
+    if (count > 0xFFFF) {
+        Log(handle,RDLC_LOG_ERR,"message too long.%u fragments",(unsigned)count);
+        return RDLC_ERR_BUFFER_TOO_SHORT;
+    }
+
+    memset(fragmenter,0,sizeof(RdlcFragmenter_t));
+    fragmenter->protoHandle = protoHandle;
+    fragmenter->addr = addr;
+    fragmenter->message = message;
+    fragmenter->messageSize = messageSize;
+    fragmenter->fragmentSize = (uint16_t)fragmentSize;
+    fragmenter->count = (uint16_t)count;
+    fragmenter->msgId = msgId;
+    return (int)count;
+}
+/**
+ * @brief 封包下一个分片
+ *
+ * @param fragmenter 分片发送器
+ * @param frameBuf 封包后的数据要放在什么位置
+ * @param frameMaxSize 允许封包后的最大长度
+ * @return int 封包后的长度，全部分片都已取出时返回0，出错时返回错误码
+ *
+ * @note 分片头和消息作为两个片段直接封包，消息不经过拷贝；出错时状态不变，换一个更大的缓冲区可以重试
+ */
+int xRdlcFragmenterNext(RdlcFragmenter_t *fragmenter,uint8_t *frameBuf,size_t frameMaxSize)
+{
+    if (!fragmenter || !fragmenter->protoHandle || !frameBuf)
+        return RDLC_ERR_INVALID_ARG;
+    if (fragmenter->index == fragmenter->count)
+        return 0;
+
+    size_t chunk = fragmenter->messageSize - fragmenter->offset;
+    if (chunk > fragmenter->fragmentSize)
+        chunk = fragmenter->fragmentSize;
+    uint32_t total = (uint32_t)fragmenter->messageSize;
+    const uint8_t header[RDLC_FRAGMENT_HEADER_SIZE] = {
+        fragmenter->msgId,
+        (uint8_t)(fragmenter->index & 0x00FF),(uint8_t)((fragmenter->index & 0xFF00) >> 8),
+        (uint8_t)(fragmenter->count & 0x00FF),(uint8_t)((fragmenter->count & 0xFF00) >> 8),
+        (uint8_t)total,(uint8_t)(total >> 8),(uint8_t)(total >> 16),(uint8_t)(total >> 24)};
+    RdlcFragment_t parts[2] = {
+        {.data = header, .size = RDLC_FRAGMENT_HEADER_SIZE},
+        {.data = (chunk > 0) ? &fragmenter->message[fragmenter->offset] : NULL, .size = (uint16_t)chunk}};
+
+    int len = xRdlcWriteFragments(fragmenter->protoHandle,fragmenter->addr,parts,2,frameBuf,frameMaxSize);
+    if (len < 0)
+        return len;
+    fragmenter->offset += chunk;
+    fragmenter->index++;
+    return len;
+}
+/**
+ * @brief 初始化分片重组器
+ *
+ * @param protoHandle RDLC实例，buffer为NULL时需要portMalloc和portFree
+ * @param reassembly 分片重组器，由调用者分配
+ * @param config 重组配置，会被拷贝
+ * @return int 错误状态码
+ *
+ * @note buffer为NULL时bufferSize是单条消息的上限：消息总长度来自对端，不设上限时一个损坏的分片头就能申请到4GiB
+ */
+int xRdlcReassemblyInit(Rdlc_t protoHandle,RdlcReassembly_t *reassembly,const RdlcReassemblyConfig_t *config)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !reassembly || !config || !config->cbMessage ||
+        (!config->buffer && (!config->bufferSize || !handle->port.portMalloc || !handle->port.portFree))) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcReassemblyInit");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    memset(reassembly,0,sizeof(RdlcReassembly_t));
+    reassembly->protoHandle = protoHandle;
+    memcpy(&reassembly->config,config,sizeof(RdlcReassemblyConfig_t));
+    return RDLC_OK;
+}
+/**
+ * @brief 放弃正在重组的消息，释放按需申请的缓冲区
+ *
+ * @param reassembly 分片重组器
+ */
+void vRdlcReassemblyAbort(RdlcReassembly_t *reassembly)
+{
+    if (!reassembly || !reassembly->protoHandle || !reassembly->message)
+        return;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)reassembly->protoHandle;
+    if (reassembly->config.buffer == NULL)
+        handle->port.portFree(reassembly->message);
+    reassembly->message = NULL;
+}
+/**
+ * @brief 把一帧载荷交给分片重组器，通常在cbParsed中调用
+ *
+ * @param reassembly 分片重组器
+ * @param addr 这一帧的地址
+ * @param payload 这一帧的载荷，以分片头开始
+ * @param payloadSize 载荷长度
+ * @param nowTick 当前时刻，只用于timeoutTicks判断，单位由调用者决定
+ * @return int 消息重组完成并已交给cbMessage时返回RDLC_OK，还在等待后续分片时返回RDLC_NOT_FINISH，出错时返回错误码
+ *
+ * @note 分片必须按顺序到达：序号0开始一条新消息(并放弃正在重组的消息)，其余分片的消息号、地址、分片总数都要与当前消息一致
+ *       且序号连续，否则当前消息被放弃并返回RDLC_ERR_NOT_ALLOWED；消息超过重组缓冲区(或按需申请时的上限bufferSize)时
+ *       返回RDLC_ERR_BUFFER_TOO_SHORT；消息总长度超过分片总数个分片能携带的长度时返回RDLC_ERR_INVALID_ARG
+ */
+int xRdlcReassemblyFeed(RdlcReassembly_t *reassembly,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize,uint32_t nowTick)
+{
+    if (!reassembly || !reassembly->protoHandle || !payload)
+        return RDLC_ERR_INVALID_ARG;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)reassembly->protoHandle;
+    RdlcReassemblyConfig_t *config = &reassembly->config;
+    if (payloadSize < RDLC_FRAGMENT_HEADER_SIZE) {
+        Log(handle,RDLC_LOG_WARN,"fragment too short");
+        return RDLC_ERR_INVALID_ARG;
+    }
+
+    uint8_t msgId = payload[0];
+    uint16_t index = ((uint16_t)payload[2] << 8) | payload[1];
+    uint16_t count = ((uint16_t)payload[4] << 8) | payload[3];
+    uint32_t total = ((uint32_t)payload[8] << 24) | ((uint32_t)payload[7] << 16) | ((uint32_t)payload[6] << 8) | payload[5];
+    const uint8_t *data = &payload[RDLC_FRAGMENT_HEADER_SIZE];
+    size_t dataSize = payloadSize - RDLC_FRAGMENT_HEADER_SIZE;
+    if (index >= count) {
+        Log(handle,RDLC_LOG_WARN,"fragment index %u of %u",(unsigned)index,(unsigned)count);
+        return RDLC_ERR_INVALID_ARG;
+    }
+
+    xRdlcReassemblyPoll(reassembly,nowTick);
+    if (index == 0) {
+        vRdlcReassemblyAbort(reassembly);
+        // 总长度来自对端，申请内存之前先检查它：每个分片最多携带msgMaxSize减去分片头的长度
+        size_t fragmentMax = (handle->payloadMaxSize > RDLC_FRAGMENT_HEADER_SIZE) ? (handle->payloadMaxSize - RDLC_FRAGMENT_HEADER_SIZE) : 0;
+        if ((uint64_t)total > (uint64_t)count * fragmentMax) {
+            Log(handle,RDLC_LOG_WARN,"message %u of %u bytes cannot fit in %u fragments",(unsigned)msgId,(unsigned)total,(unsigned)count);
+            return RDLC_ERR_INVALID_ARG;
+        }
+        if (total > config->bufferSize) {
+            Log(handle,RDLC_LOG_ERR,"message too long.expect %u but %u",(unsigned)config->bufferSize,(unsigned)total);
+            return RDLC_ERR_BUFFER_TOO_SHORT;
+        }
+        if (config->buffer != NULL)
+            reassembly->message = config->buffer;
+        else {
+            reassembly->message = (uint8_t *)handle->port.portMalloc((total > 0) ? total : 1);
+            if (reassembly->message == NULL)
+                return RDLC_ERR_NO_MEM;
+        }
+        reassembly->messageSize = total;
+        reassembly->filled = 0;
+        reassembly->addr = addr;
+        reassembly->nextIndex = 0;
+        reassembly->count = count;
+        reassembly->msgId = msgId;
+    }
+    else if ((reassembly->message == NULL) || (index != reassembly->nextIndex) || (msgId != reassembly->msgId) ||
+             (count != reassembly->count) || (total != reassembly->messageSize) ||
+             (addr.srcAddr != reassembly->addr.srcAddr) || (addr.dstAddr != reassembly->addr.dstAddr)) {
+        Log(handle,RDLC_LOG_WARN,"fragment %u of message %u out of order",(unsigned)index,(unsigned)msgId);
+        vRdlcReassemblyAbort(reassembly);
+        return RDLC_ERR_NOT_ALLOWED;
+    }
+
+    if (dataSize > reassembly->messageSize - reassembly->filled) {
+        Log(handle,RDLC_LOG_WARN,"fragment overruns message %u",(unsigned)msgId);
+        vRdlcReassemblyAbort(reassembly);
+        return RDLC_ERR_INVALID_ARG;
+    }
+    if (dataSize > 0)
+        memcpy(&reassembly->message[reassembly->filled],data,dataSize);
+    reassembly->filled += dataSize;
+    reassembly->nextIndex++;
+    reassembly->lastTick = nowTick;
+    if (reassembly->nextIndex < reassembly->count)
+        return RDLC_NOT_FINISH;
+
+    if (reassembly->filled != reassembly->messageSize) {
+        Log(handle,RDLC_LOG_WARN,"message %u incomplete",(unsigned)msgId);
+        vRdlcReassemblyAbort(reassembly);
+        return RDLC_ERR_INVALID_ARG;
+    }
+    config->cbMessage(reassembly->protoHandle,reassembly->addr,reassembly->message,reassembly->messageSize);
+    vRdlcReassemblyAbort(reassembly);
+    return RDLC_OK;
+}
+/**
+ * @brief 检查正在重组的消息是否超时，应在接收线程中周期性调用
+ *
+ * @param reassembly 分片重组器
+ * @param nowTick 当前时刻，与xRdlcReassemblyFeed使用同一个时钟，允许回绕
+ * @return int 放弃了超时的消息时返回RDLC_ERR_TIMEOUT，否则返回RDLC_OK
+ */
+int xRdlcReassemblyPoll(RdlcReassembly_t *reassembly,uint32_t nowTick)
+{
+    if (!reassembly || !reassembly->protoHandle)
+        return RDLC_ERR_INVALID_ARG;
+    if ((reassembly->message == NULL) || (reassembly->config.timeoutTicks == 0))
+        return RDLC_OK;
+    if ((uint32_t)(nowTick - reassembly->lastTick) < reassembly->config.timeoutTicks)
+        return RDLC_OK;
+    Log((RdlcStaticHandle_t*)reassembly->protoHandle,RDLC_LOG_WARN,"message %u timeout",(unsigned)reassembly->msgId);
+    vRdlcReassemblyAbort(reassembly);
+    return RDLC_ERR_TIMEOUT;
+}
+/**
+ * @brief 初始化分发表，清空所有路由
+ *
+ * @param dispatch 待初始化的分发表
+ * @param fallback 目的地址未注册或源地址不符时的回调，可以为NULL(丢弃)
+ * @param ctx 传给fallback的上下文
+ * @return int 错误状态码
+ */
+int xRdlcDispatchInit(RdlcDispatch_t *dispatch,RdlcOnRoute_fptr fallback,void *ctx)
+{
+    if (!dispatch)
+        return RDLC_ERR_INVALID_ARG;
+    for (int i = 0; i < 256; i++) {
+        dispatch->routes[i].handler = NULL;
+        dispatch->routes[i].ctx = NULL;
+        dispatch->routes[i].srcAddr = RDLC_ADDR_ANY;
+    }
+    dispatch->fallback.handler = fallback;
+    dispatch->fallback.ctx = ctx;
+    dispatch->fallback.srcAddr = RDLC_ADDR_ANY;
+    return RDLC_OK;
+}
+/**
+ * @brief 为一个目的地址注册回调
+ *
+ * @param dispatch 分发表
+ * @param srcAddr 只接受这个源地址发来的帧，RDLC_ADDR_ANY表示不限
+ * @param dstAddr 目的地址
+ * @param handler 回调，为NULL时注销这个目的地址
+ * @param ctx 传给回调的上下文
+ * @return int 错误状态码
+ *
+ * @note 每个目的地址只有一项，重复注册会覆盖之前的回调；需要按源地址区分时，在回调中使用地址参数
+ * @note 修改分发表与解包不能同时进行，应在同一个上下文中调用，或在修改期间停止接收
+ */
+int xRdlcDispatchRegister(RdlcDispatch_t *dispatch,int srcAddr,uint8_t dstAddr,RdlcOnRoute_fptr handler,void *ctx)
+{
+    if (!dispatch || (srcAddr != RDLC_ADDR_ANY && (srcAddr < 0 || srcAddr > 0xFF)))
+        return RDLC_ERR_INVALID_ARG;
+    RdlcRoute_t *route = &dispatch->routes[dstAddr];
+    route->handler = handler;
+    route->ctx = handler ? ctx : NULL;
+    route->srcAddr = handler ? (int16_t)srcAddr : RDLC_ADDR_ANY;
+    return RDLC_OK;
+}
+/**
+ * @brief 获取一帧封包后的精确长度，可用于按需分配发送缓冲区
+ *
+ * @param protoHandle RDLC实例
+ * @param addr 目的地址和源地址
+ * @param payload 原始数据所在地址
+ * @param payloadSize 原始数据长度
+ * @return int 封包后的长度，出错时返回错误码
+ *
+ * @note 需要遍历一次载荷来统计转义字符和计算CRC(CRC字段也可能被转义)
+ */
+int xRdlcGetFrameSize(Rdlc_t protoHandle,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || !payload) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcGetFrameSize");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    if (payloadSize > handle->payloadMaxSize) {
+        Log(handle,RDLC_LOG_ERR,"payload too long.expect %u but %u",(unsigned)handle->payloadMaxSize,(unsigned)payloadSize);
+        return RDLC_ERR_INVALID_ARG;
+    }
+    return prvTxBufferExactSize(handle,addr,payload,payloadSize);
+}
+/**
+ * @brief 复位RDLC实例的接收状态
+ *
+ * @param protoHandle RDLC实例
+ * @return int 错误状态码
+ */
+void vRdlcReset(Rdlc_t protoHandle)
+{
+    if (!protoHandle) return;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+
+    memset(handle->rxBuf,0,handle->rxBufSize);
+    handle->payloadSize = 0;
+    handle->rxIndexer = 0;
+    handle->stateEscape = 0;
+    handle->stateParse = RDLC_STATE_PARSE_WAIT_HEAD;
+    handle->stateEscape = RDLC_STATE_ESCAPE_WAIT;
+}
+/**
+ * @brief 获取RDLC实例的内部解析状态
+ *
+ * @param protoHandle RDLC实例
+ * @return int 解析状态机状态
+ */
+int xRdlcGetParseState(Rdlc_t protoHandle)
+{
+    if (!protoHandle) return RDLC_ERR_NOT_ALLOWED;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    return handle->stateParse;
+    return 0;
+}
+/**
+ * @brief 获取RDLC实例的内部转义状态
+ *
+ * @param protoHandle RDLC实例
+ * @return int 解析状态机状态
+ */
+int xRdlcGetEscapeState(Rdlc_t protoHandle)
+{
+    if (!protoHandle) return RDLC_ERR_NOT_ALLOWED;
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    return handle->stateEscape;
+    return 0;
 }
 /**
  * @brief 获取RDLC实例的日志层次
@@ -794,3 +2833,43 @@ void vRdlcSetLogLevel(Rdlc_t protoHandle,RdlcLogLevel_t level)
     RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
     handle->logLevel = level;
 }
+/**
+ * @brief 设置RDLC实例的目的地址过滤器
+ *
+ * @param protoHandle RDLC实例
+ * @param filter 过滤器，为NULL时接收所有目的地址
+ * @return int 错误状态码
+ *
+ * @note 目的地址未通过过滤的帧在收到目的地址后立即跳过：不写入接收缓冲区、不计算CRC、不执行回调，只等待帧尾或下一个帧头；
+ *       例如节点地址在运行时才分配时，可以在分配后调用。不能与解包同时进行
+ */
+int xRdlcSetAddrFilter(Rdlc_t protoHandle,const RdlcAddrFilter_t *filter)
+{
+    RdlcStaticHandle_t *handle = (RdlcStaticHandle_t*)protoHandle;
+    if (!protoHandle || (filter && filter->mode > RDLC_ADDR_FILTER_BITMAP)) {
+        Log(handle,RDLC_LOG_ERR,"invalid arguments for xRdlcSetAddrFilter");
+        return RDLC_ERR_INVALID_ARG;
+    }
+    prvRxAcceptMapInit(handle,filter);
+    return RDLC_OK;
+}
+/**
+ * @brief 使用RDLC实例的CRC引擎累计CRC-16/MODBUS(0xA001)
+ *
+ * @param protoHandle RDLC实例，为NULL时使用软件引擎
+ * @param crc 当前的CRC，首次计算请传入RDLC_CRC16_INIT_VALUE
+ * @param data 数据
+ * @param length 数据长度
+ * @return uint16_t 累计后的CRC
+ *
+ * @note 分段调用的结果与一次性计算整段数据相同
+ */
+uint16_t xRdlcCrc16Update(Rdlc_t protoHandle,uint16_t crc,const uint8_t *data,size_t length)
+{
+    if (!data) return crc;
+    if (!protoHandle) {
+        prvCrc16Init();
+        return prvCrc16Update(crc,data,length);
+    }
+    return prvCrc16((RdlcStaticHandle_t *)protoHandle,crc,data,length);
+}
@@ -18,9 +18,35 @@ extern "C" {
 #include <stdarg.h>
 
 /// 配置宏
-#define RDLC_CRC16_USE_CALCULATE  0 ///< 在线计算获取CRC
-#define RDLC_CRC16_USE_TABLE      1 ///< 使用查表法获取CRC，空间换时间
+// CRC16引擎，有且只能选择一个，结果都是CRC-16/MODBUS(0xA001)；RdlcPort_t.portCrc16不为NULL时优先使用硬件
+#ifndef RDLC_CRC16_USE_CALCULATE
+#define RDLC_CRC16_USE_CALCULATE  0 ///< 在线计算获取CRC，每字节8次移位，不占用表空间
+#endif
+#ifndef RDLC_CRC16_USE_NIBBLE
+#define RDLC_CRC16_USE_NIBBLE     0 ///< 使用32项半字节表(64字节)获取CRC，适合Flash紧张的MCU
+#endif
+#ifndef RDLC_CRC16_USE_TABLE
+#define RDLC_CRC16_USE_TABLE      1 ///< 使用查表法获取CRC，空间换时间(512字节)
+#endif
+#ifndef RDLC_CRC16_USE_SLICING4
+#define RDLC_CRC16_USE_SLICING4   0 ///< 使用slicing-by-4查表获取CRC，每次处理4字节(2KB表，运行时生成在RAM中)，适合Linux主机
+#endif
+#ifndef RDLC_CRC16_USE_SLICING8
+#define RDLC_CRC16_USE_SLICING8   0 ///< 使用slicing-by-8查表获取CRC，每次处理8字节(4KB表，运行时生成在RAM中)，适合Linux主机
+#endif
 #define RDLC_LOG_ENABLE           1 ///< 是否启用日志
+#ifndef RDLC_SIMD_ENABLE
+#define RDLC_SIMD_ENABLE          1 ///< 是否在x86-64(SSE2/AVX2)和AArch64(NEON)上使用SIMD查找转义字符，其他平台自动退回标量实现
+#endif
+#ifndef RDLC_CRC16_INCREMENTAL
+#define RDLC_CRC16_INCREMENTAL    1 ///< 接收载荷时逐段累计CRC，使帧尾的校验耗时与载荷长度无关；取0则在收到帧尾时一次性计算
+#endif
+#ifndef RDLC_CRC16_CLMUL_ENABLE
+#define RDLC_CRC16_CLMUL_ENABLE   1 ///< 在x86-64(PCLMULQDQ)和AArch64(PMULL)上用无进位乘法折叠计算长数据的CRC，运行时检测CPU，不支持时退回查表；只对TABLE和SLICING引擎生效
+#endif
+#ifndef RDLC_CACHE_LINE_SIZE
+#define RDLC_CACHE_LINE_SIZE      64 ///< 字节环中生产者和消费者的成员之间填充的字节数，应不小于CPU的缓存行；没有数据缓存的MCU可以取4节省RAM
+#endif
 
 /// 日志层次
 typedef enum{
@@ -39,6 +65,13 @@ typedef enum{
 #define RDLC_ERR_INVALID_ARG -4
 #define RDLC_ERR_BUFFER_TOO_SHORT -5
 #define RDLC_ERR_NO_MEM -6
+#define RDLC_ERR_POOL_EMPTY -7
+#define RDLC_ERR_TIMEOUT -8
+#define RDLC_ERR_IO -9
+
+/// 配置标志
+#define RDLC_FLAG_RX_ZERO_COPY (1u << 0) ///< 零拷贝接收：完整落在一次xRdlcReadBytes输入中且不含转义的帧，直接把输入缓冲区中的载荷交给回调
+#define RDLC_FLAG_WIDE_LENGTH  (1u << 1) ///< 宽长度帧：允许msgMaxSize超过65535，载荷超过65535字节的帧以0xFF 0xC1开头，载荷长度为uint32_t小端；其余帧格式不变
 
 // 转义状态
 #define RDLC_STATE_ESCAPE_WAIT 0 ///< 无需转义
@@ -53,11 +86,20 @@ typedef enum{
 #define RDLC_STATE_PARSE_GET_CRCL 6    ///< 等待校验码低八位
 #define RDLC_STATE_PARSE_GET_CRCH 7    ///< 等待校验码高八位
 #define RDLC_STATE_PARSE_GET_TAIL 8    ///< 等待帧尾
+#define RDLC_STATE_PARSE_GET_LEN2 9    ///< 等待宽长度帧载荷长度的第三个字节
+#define RDLC_STATE_PARSE_GET_LEN3 10   ///< 等待宽长度帧载荷长度的第四个字节
+#define RDLC_STATE_PARSE_SKIP 11       ///< 目的地址未通过过滤，跳过本帧直到帧尾或下一个帧头
+// 流式封包状态
+#define RDLC_STATE_ENCODE_HEAD 0    ///< 输出帧头
+#define RDLC_STATE_ENCODE_PAYLOAD 1 ///< 输出载荷
+#define RDLC_STATE_ENCODE_TAIL 2    ///< 输出帧尾
+#define RDLC_STATE_ENCODE_DONE 3    ///< 整帧输出完毕
 
 // 底层接口定义
 typedef void* (*RdlcMalloc_fptr)(size_t);
 typedef void  (*RdlcFree_fptr)  (void*);
 typedef int   (*RdlcPrintf_fptr)(RdlcLogLevel_t level,const char *fmt,va_list args);
+typedef uint16_t (*RdlcCrc16_fptr)(uint16_t crc,const uint8_t *data,size_t length);///< (当前CRC,数据,长度)，返回累计后的CRC-16/MODBUS
 
 /// 地址
 typedef struct{
@@ -65,18 +107,56 @@ typedef struct{
     uint8_t dstAddr; ///< 目的地址
 }RdlcAddr_t;
 
+/// 载荷片段
+typedef struct{
+    const uint8_t *data; ///< 片段起始地址
+    uint16_t size;       ///< 片段长度
+}RdlcFragment_t;
+
+/// 目的地址过滤方式
+#define RDLC_ADDR_FILTER_NONE   0 ///< 接收所有目的地址
+#define RDLC_ADDR_FILTER_EXACT  1 ///< 只接收dstAddr == addr
+#define RDLC_ADDR_FILTER_MASK   2 ///< 只接收(dstAddr & mask) == (addr & mask)
+#define RDLC_ADDR_FILTER_BITMAP 3 ///< 只接收bitmap中对应位为1的目的地址
+
+/// 目的地址过滤器类型
+typedef struct{
+    uint8_t mode;        ///< RDLC_ADDR_FILTER_*
+    uint8_t addr;        ///< EXACT和MASK方式下的地址
+    uint8_t mask;        ///< MASK方式下参与比较的位
+    uint32_t bitmap[8];  ///< BITMAP方式下每个目的地址一位，第dstAddr位在bitmap[dstAddr / 32]的第dstAddr % 32位
+}RdlcAddrFilter_t;
+
 /// 类定义
 typedef void* Rdlc_t;
 
 // 基本接口类型定义
 typedef int (*RdlcOnParse_fptr) (Rdlc_t,RdlcAddr_t,const uint8_t*,uint16_t);///< (句柄,地址,载荷,长度)
 typedef int (*RdlcOnError_fptr) (Rdlc_t,int);
+typedef int (*RdlcOnParseWide_fptr) (Rdlc_t,RdlcAddr_t,const uint8_t*,size_t);///< (句柄,地址,载荷,长度)，用于超过65535字节的载荷
+typedef int (*RdlcOnRoute_fptr) (Rdlc_t,RdlcAddr_t,const uint8_t*,size_t,void*);///< (句柄,地址,载荷,长度,注册时的上下文)
+
+#define RDLC_ADDR_ANY (-1) ///< 注册分发表时不限定源地址
+
+/// 分发表中的一项
+typedef struct{
+    RdlcOnRoute_fptr handler; ///< 为NULL表示未注册
+    void *ctx;
+    int16_t srcAddr;          ///< 只接受这个源地址，RDLC_ADDR_ANY表示不限
+}RdlcRoute_t;
+
+/// 分发表定义，由xRdlcDispatchInit初始化，通过RdlcConfig_t.dispatch交给RDLC实例；按目的地址直接索引，查找只需一次下标运算
+typedef struct{
+    RdlcRoute_t routes[256]; ///< 以目的地址为下标
+    RdlcRoute_t fallback;    ///< 目的地址未注册或源地址不符时使用，可以为空
+}RdlcDispatch_t;
 
 /// 接口类型
 typedef struct{
     RdlcMalloc_fptr portMalloc;
     RdlcFree_fptr portFree;
     RdlcPrintf_fptr portPrintf;
+    RdlcCrc16_fptr portCrc16; ///< 硬件CRC外设(如STM32/CH32的CRC单元)，可以为NULL
 }RdlcPort_t;
 
 /// 对象定义
@@ -85,32 +165,170 @@ typedef struct{
     uint8_t stateEscape;
 
     uint8_t *rxBuf;
-    uint16_t rxBufSize;
+    uint32_t rxBufSize;
 
-    uint16_t rxIndexer;
-    uint16_t payloadSize;
+    uint32_t rxIndexer;
+    uint32_t payloadSize;
+
+    uint32_t payloadMaxSize;
+    uint32_t payloadMaxEscapeSize;
 
-    uint16_t payloadMaxSize;
-    uint16_t payloadMaxEscapeSize;
+    uint16_t rxCrc;
+    uint16_t flags;
+    uint8_t rxHeadSize; ///< 接收缓冲区中载荷之前的长度：地址2字节 + 载荷长度2字节，宽长度帧为4字节
 
     RdlcOnParse_fptr cbParsed;
     RdlcOnError_fptr cbError;
+    RdlcOnParseWide_fptr cbParsedWide;
     RdlcPort_t port;
     RdlcLogLevel_t logLevel;
+
+    uint8_t *framePool;        ///< 帧池，framePoolCount个定长块连续存放，未启用时为NULL
+    uint16_t *framePoolNext;   ///< 每个空闲块指向的下一个空闲块
+    size_t frameBlockSize;     ///< 块的跨度，按8字节对齐
+    uint16_t framePoolCount;
+    uint32_t framePoolHead;    ///< 空闲链表头：低16位是块号，高16位是每次修改递增的版本号，防止ABA
+
+    RdlcDispatch_t *dispatch;
+    uint32_t acceptMap[8];     ///< 由目的地址过滤器展开的位图，第dstAddr位为1时接收
 }RdlcStaticHandle_t;
 
+/// 流式封包器定义，由xRdlcEncoderInit初始化，成员不应被用户直接修改
+typedef struct{
+    Rdlc_t protoHandle;
+    const uint8_t *payload;
+    uint16_t payloadSize;
+    uint16_t payloadIndexer; ///< 下一个待输出的载荷字节
+    uint16_t crc;            ///< 已输出载荷的CRC
+    uint8_t stateEncode;
+    uint8_t escapePending;   ///< 上一块末尾的0xFF还差一个转义字节没有输出
+    uint8_t frame[10];       ///< 转义后的帧头或帧尾
+    uint8_t frameSize;
+    uint8_t frameIndexer;
+}RdlcEncoder_t;
+
+/// 批量封包的输出回调：(句柄,拼接好的帧,总长度,每帧在data中的偏移,帧数)，偏移数组未配置时为NULL
+typedef int (*RdlcBatchFlush_fptr)(Rdlc_t,const uint8_t*,uint16_t,const uint16_t*,uint16_t);
+
+/// 批量封包配置类型
+typedef struct{
+    uint8_t *buffer;             ///< 拼接帧的缓冲区
+    uint16_t bufferSize;
+    uint16_t *offsets;           ///< 记录每帧偏移的数组，可以为NULL
+    uint16_t offsetsMax;         ///< 偏移数组的容量，也是每批最多的帧数；offsets为NULL时取0表示不限
+    uint16_t flushSize;          ///< 累计长度达到此值时立即输出，取0则只在缓冲区放不下时输出
+    uint32_t flushTicks;         ///< 第一帧入队后经过此时长(单位由调用者的时钟决定)时输出，取0不启用
+    RdlcBatchFlush_fptr cbFlush; ///< 输出回调，例如一次write()；返回负数表示输出失败，xRdlcBatchAppend会把它返回给调用者
+}RdlcBatchConfig_t;
+
+/// 批量封包器定义，由xRdlcBatchInit初始化，成员不应被用户直接修改
+typedef struct{
+    Rdlc_t protoHandle;
+    RdlcBatchConfig_t config;
+    uint16_t used;      ///< 缓冲区中已有的字节数
+    uint16_t count;     ///< 缓冲区中已有的帧数
+    uint32_t firstTick; ///< 第一帧入队的时刻
+}RdlcBatch_t;
+
+/// 分片发送器定义，由xRdlcFragmenterInit初始化，成员不应被用户直接修改
+typedef struct{
+    Rdlc_t protoHandle;
+    RdlcAddr_t addr;
+    const uint8_t *message;
+    size_t messageSize;
+    size_t offset;          ///< 下一个分片在消息中的起点
+    uint16_t fragmentSize;  ///< 每个分片携带的消息长度
+    uint16_t index;         ///< 下一个分片的序号
+    uint16_t count;         ///< 分片总数
+    uint8_t msgId;
+}RdlcFragmenter_t;
+
+/// 重组完成的回调：(句柄,地址,消息,长度)，消息只在回调期间有效
+typedef int (*RdlcOnMessage_fptr)(Rdlc_t,RdlcAddr_t,const uint8_t*,size_t);
+
+/// 分片重组配置类型
+typedef struct{
+    uint8_t *buffer;             ///< 重组缓冲区；为NULL时每条消息用portMalloc按总长度申请，完成或放弃后释放
+    size_t bufferSize;           ///< 重组缓冲区的长度；buffer为NULL时是单条消息的上限，不能为0
+    uint32_t timeoutTicks;       ///< 两个分片之间超过此时长(单位由调用者的时钟决定)则放弃这条消息，取0不启用
+    RdlcOnMessage_fptr cbMessage;
+}RdlcReassemblyConfig_t;
+
+/// 分片重组器定义，由xRdlcReassemblyInit初始化，成员不应被用户直接修改；每个重组器同一时刻只重组一条消息
+typedef struct{
+    Rdlc_t protoHandle;
+    RdlcReassemblyConfig_t config;
+    uint8_t *message;       ///< 正在重组的消息，NULL表示空闲
+    uint32_t messageSize;   ///< 消息总长度
+    uint32_t filled;        ///< 已收到的长度
+    uint32_t lastTick;      ///< 收到上一个分片的时刻
+    RdlcAddr_t addr;
+    uint16_t nextIndex;     ///< 期待的下一个分片序号
+    uint16_t count;
+    uint8_t msgId;
+}RdlcReassembly_t;
+
+/// 单生产者单消费者字节环定义，由xRdlcRingInit初始化，成员不应被用户直接修改
+/// 生产者(例如串口中断)只写head和tailCache，消费者(例如任务)只写tail和headCache，两组成员分处不同的缓存行
+typedef struct{
+    uint8_t *buffer;
+    uint32_t mask;        ///< 容量减一，容量是2的幂
+    uint8_t padProducer[RDLC_CACHE_LINE_SIZE];
+    uint32_t head;        ///< 已写入的字节总数，回绕计数
+    uint32_t tailCache;   ///< 生产者上次读到的tail，只在看起来写满时重新读取
+    uint32_t dropped;     ///< 统计：写满时丢弃的字节数
+    uint8_t padConsumer[RDLC_CACHE_LINE_SIZE];
+    uint32_t tail;        ///< 已取走的字节总数，回绕计数
+    uint32_t headCache;   ///< 消费者上次读到的head，只在看起来为空时重新读取
+    uint8_t padEnd[RDLC_CACHE_LINE_SIZE];
+}RdlcRing_t;
+
+/// 循环DMA接收器定义，由xRdlcDmaRxInit初始化，成员不应被用户直接修改
+typedef struct{
+    Rdlc_t protoHandle;
+    uint8_t *buffer;     ///< 循环模式DMA的目标缓冲区
+    uint32_t size;
+    uint32_t readIndex;  ///< 下一个待解析的位置
+}RdlcDmaRx_t;
+
+/// 分段接收配置类型
+typedef struct{
+    uint8_t *slots;      ///< 帧队列，slotCount个槽连续存放，每槽slotSize字节
+    uint16_t slotSize;   ///< 每槽的长度，取RDLC_SPLIT_SLOT_SIZE(msgMaxSize)，装不下的帧被丢弃
+    uint16_t slotCount;  ///< 槽数，必须是2的幂
+}RdlcSplitRxConfig_t;
+
+/// 分段接收器定义，由xRdlcSplitRxInit初始化，成员不应被用户直接修改
+/// 中断侧只解转义并按帧头帧尾把帧放入队列，任务侧再校验长度和CRC并执行回调
+typedef struct{
+    Rdlc_t protoHandle;
+    RdlcSplitRxConfig_t config;
+    uint8_t *slot;       ///< 中断侧：正在填写的槽，NULL表示不在帧内
+    uint16_t fill;       ///< 中断侧：当前槽中已有的字节数，含2字节长度
+    uint8_t escape;      ///< 中断侧：上一个字节是转义字符
+    uint32_t head;       ///< 中断侧：已放入队列的帧数，回绕计数
+    uint32_t tailCache;  ///< 中断侧：上次读到的tail，只在看起来队列满时重新读取
+    uint32_t dropped;    ///< 统计：队列满或超过slotSize而丢弃的帧数
+    uint32_t tail;       ///< 任务侧：已处理的帧数，回绕计数
+}RdlcSplitRx_t;
+
 /// 配置类型
 typedef struct{
-    uint16_t msgMaxSize;
-    uint16_t msgMaxEscapeSize;
+    uint32_t msgMaxSize;       ///< 超过65535时需要RDLC_FLAG_WIDE_LENGTH
+    uint32_t msgMaxEscapeSize;
     RdlcOnParse_fptr cbParsed;
     RdlcOnError_fptr cbError;
+    uint16_t flags; ///< RDLC_FLAG_*的组合，不需要时取0
+    uint16_t framePoolCount; ///< 帧池中预分配的帧数，xRdlcFrameCreate从池中取帧；取0则每次调用portMalloc。只对xRdlcCreate生效
+    RdlcOnParseWide_fptr cbParsedWide; ///< 不为NULL时代替cbParsed，可以收到超过65535字节的载荷
+    RdlcDispatch_t *dispatch;          ///< 不为NULL时按目的地址查表分发，代替cbParsed和cbParsedWide；分发表由调用者持有，生命周期不短于RDLC实例
+    const RdlcAddrFilter_t *addrFilter; ///< 目的地址过滤器，为NULL时接收所有目的地址；只在创建时读取
 }RdlcConfig_t;
 
 // RDLC对象的构造函数和析构函数
 Rdlc_t xRdlcCreate(const RdlcConfig_t *config,const RdlcPort_t *port);
 void   vRdlcDestroy(Rdlc_t protoHandle);
-Rdlc_t xRdlcCreateStatic(const RdlcConfig_t *config,const RdlcPort_t *port,RdlcStaticHandle_t* staticHandle,uint8_t *rxBuffer,uint16_t rxBufferSize);
+Rdlc_t xRdlcCreateStatic(const RdlcConfig_t *config,const RdlcPort_t *port,RdlcStaticHandle_t* staticHandle,uint8_t *rxBuffer,uint32_t rxBufferSize);
 
 // RDLC最大帧的构造函数和析构函数
 int    xRdlcFrameCreate(Rdlc_t protoHandle,uint8_t **frame,uint16_t *size);
@@ -118,12 +336,53 @@ void   vRdlcFrameDestroy(Rdlc_t protoHandle,uint8_t *frame);
 
 // 对象方法1：解包
 int xRdlcReadByte(Rdlc_t protoHandle,uint8_t byte);
-int xRdlcReadBytes(Rdlc_t protoHandle,uint8_t *buffer,uint16_t size);
+int xRdlcReadBytes(Rdlc_t protoHandle,uint8_t *buffer,size_t size);
+int xRdlcRingInit(RdlcRing_t *ring,uint8_t *buffer,uint32_t size);
+int xRdlcRingPushByte(RdlcRing_t *ring,uint8_t byte);
+uint32_t xRdlcRingPush(RdlcRing_t *ring,const uint8_t *data,uint32_t size);
+uint32_t xRdlcRingPeek(RdlcRing_t *ring,const uint8_t **data);
+void vRdlcRingConsume(RdlcRing_t *ring,uint32_t size);
+int xRdlcRingDrain(Rdlc_t protoHandle,RdlcRing_t *ring);
+int xRdlcDmaRxInit(Rdlc_t protoHandle,RdlcDmaRx_t *dma,uint8_t *buffer,uint32_t size);
+int xRdlcDmaRxUpdate(RdlcDmaRx_t *dma,uint32_t writeIndex);
+int xRdlcSplitRxInit(Rdlc_t protoHandle,RdlcSplitRx_t *split,const RdlcSplitRxConfig_t *config);
+int xRdlcSplitRxIsrByte(RdlcSplitRx_t *split,uint8_t byte);
+int xRdlcSplitRxIsrBytes(RdlcSplitRx_t *split,const uint8_t *buffer,size_t size);
+int xRdlcSplitRxPoll(RdlcSplitRx_t *split);
 
 // 对象方法2：封包
+// 各封包接口都接受长度为0的载荷(如心跳帧)，接收端照常校验CRC后以长度0回调
 int xRdlcWriteBytes(Rdlc_t protoHandle,RdlcAddr_t addr,
+                    const uint8_t *payload,size_t payloadSize,
+                    uint8_t *frameBuf,size_t frameMaxSize);
+int xRdlcWriteFragments(Rdlc_t protoHandle,RdlcAddr_t addr,
+                        const RdlcFragment_t *fragments,uint16_t fragmentCount,
+                        uint8_t *frameBuf,size_t frameMaxSize);
+int xRdlcWriteIovec(Rdlc_t protoHandle,RdlcAddr_t addr,
                     const uint8_t *payload,uint16_t payloadSize,
-                    uint8_t *frameBuf,uint16_t frameMaxSize);
+                    RdlcFragment_t *iov,uint16_t iovMaxCount,
+                    uint8_t *scratch,uint16_t scratchSize);
+int xRdlcWriteInPlace(Rdlc_t protoHandle,RdlcAddr_t addr,
+                      uint8_t *buffer,uint16_t bufferSize,
+                      uint16_t headroom,uint16_t payloadSize,
+                      uint8_t **frame);
+int xRdlcEncoderInit(Rdlc_t protoHandle,RdlcEncoder_t *encoder,RdlcAddr_t addr,
+                     const uint8_t *payload,uint16_t payloadSize);
+int xRdlcEncoderPull(RdlcEncoder_t *encoder,uint8_t *buffer,uint16_t size);
+int xRdlcBatchInit(Rdlc_t protoHandle,RdlcBatch_t *batch,const RdlcBatchConfig_t *config);
+int xRdlcBatchAppend(RdlcBatch_t *batch,RdlcAddr_t addr,const uint8_t *payload,uint16_t payloadSize,uint32_t nowTick);
+int xRdlcBatchPoll(RdlcBatch_t *batch,uint32_t nowTick);
+int xRdlcBatchFlush(RdlcBatch_t *batch);
+int xRdlcFragmenterInit(Rdlc_t protoHandle,RdlcFragmenter_t *fragmenter,RdlcAddr_t addr,uint8_t msgId,
+                        const uint8_t *message,size_t messageSize);
+int xRdlcFragmenterNext(RdlcFragmenter_t *fragmenter,uint8_t *frameBuf,size_t frameMaxSize);
+int xRdlcReassemblyInit(Rdlc_t protoHandle,RdlcReassembly_t *reassembly,const RdlcReassemblyConfig_t *config);
+int xRdlcReassemblyFeed(RdlcReassembly_t *reassembly,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize,uint32_t nowTick);
+int xRdlcReassemblyPoll(RdlcReassembly_t *reassembly,uint32_t nowTick);
+void vRdlcReassemblyAbort(RdlcReassembly_t *reassembly);
+int xRdlcGetFrameSize(Rdlc_t protoHandle,RdlcAddr_t addr,const uint8_t *payload,size_t payloadSize);
+int xRdlcDispatchInit(RdlcDispatch_t *dispatch,RdlcOnRoute_fptr fallback,void *ctx);
+int xRdlcDispatchRegister(RdlcDispatch_t *dispatch,int srcAddr,uint8_t dstAddr,RdlcOnRoute_fptr handler,void *ctx);
 
 // 对象方法3：流控
 int xRdlcReset(Rdlc_t protoHandle);
@@ -136,6 +395,13 @@ int xRdlcGetEscapeState(Rdlc_t protoHandle);
 RdlcLogLevel_t xRdlcGetLogLevel(Rdlc_t protoHandle);
 void vRdlcSetLogLevel(Rdlc_t protoHandle,RdlcLogLevel_t level);
 
+// 对象成员2：目的地址过滤
+int xRdlcSetAddrFilter(Rdlc_t protoHandle,const RdlcAddrFilter_t *filter);
+
+// 类方法2：CRC16
+#define RDLC_CRC16_INIT_VALUE 0xFFFF ///< CRC-16/MODBUS的初值
+uint16_t xRdlcCrc16Update(Rdlc_t protoHandle,uint16_t crc,const uint8_t *data,size_t length);
+
 /**
  * @brief 类方法1：使用静态方式获取最小的帧长度，可用于提前给定发送帧的内存，或是动态申请合适长度的帧
  * 
@@ -144,7 +410,13 @@ void vRdlcSetLogLevel(Rdlc_t protoHandle,RdlcLogLevel_t level);
  * 
  * @return 最小帧长度
  */
-#define RDLC_GET_FRAME_SIZE(MSG_SIZE,MSG_ESCAPE_MAX_SIZE) (10 + (MSG_SIZE) + (MSG_ESCAPE_MAX_SIZE) + 6)// 最大转义头 + 数据 + 转义 + 最大转义尾
+#define RDLC_GET_FRAME_SIZE(MSG_SIZE,MSG_ESCAPE_MAX_SIZE) ((((MSG_SIZE) > 0xFFFF) ? 14 : 10) + (MSG_SIZE) + (MSG_ESCAPE_MAX_SIZE) + 6)// 最大转义头(宽长度帧为14) + 数据 + 转义 + 最大转义尾
+#define RDLC_SPLIT_SLOT_SIZE(MSG_SIZE) ((MSG_SIZE) + 8)// 分段接收每槽的长度：槽内帧长2字节 + 地址2字节 + 载荷长度2字节 + 载荷 + CRC 2字节
+
+#define RDLC_IOV_SCRATCH_SIZE (10 + 6) ///< xRdlcWriteIovec暂存区的大小：最大转义头 + 最大转义尾
+#define RDLC_FRAGMENT_HEADER_SIZE 9 ///< 分片头的长度：消息号(1) 分片序号(2) 分片总数(2) 消息总长度(4)，均为小端
+#define RDLC_INPLACE_HEADROOM 10 ///< xRdlcWriteInPlace在载荷之前需要预留的长度：最大转义头
+#define RDLC_INPLACE_TAILROOM(MSG_ESCAPE_MAX_SIZE) ((MSG_ESCAPE_MAX_SIZE) + 6) ///< xRdlcWriteInPlace在载荷之后需要预留的长度：转义 + 最大转义尾
 
 
 
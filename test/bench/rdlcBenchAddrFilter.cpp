@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "rdlc.h"
+
+/**
+ *@brief ܲԣ8ڵ㹲һߣÿ֡ĿĵַȷֲֻշԼ֡
+ *
+ * ʱÿһ֡ҪغɲУCRCصٶ˵֡
+ * ʱ˵֡Ŀĵֱַ֮֡βֱͳxRdlcReadBytesxRdlcReadByteֽʱÿֽڵĺʱ
+**/
+
+typedef std::chrono::steady_clock BenchClock_t;
+
+#define BENCH_NODES   8
+#define BENCH_SELF    3
+
+static volatile uint32_t BenchMine;
+
+extern "C" int RdlcBenchCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    if (addr.dstAddr == BENCH_SELF)
+        BenchMine = BenchMine + 1;
+    return 0;
+}
+
+static Rdlc_t RdlcBenchCreate(uint16_t msgMaxSize,const RdlcAddrFilter_t *filter)
+{
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = RdlcBenchCallback,
+        .cbError = NULL,
+        .addrFilter = filter,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    return xRdlcCreate(&config,&port);
+}
+
+static double RdlcBenchNsPerByte(Rdlc_t handle,const std::vector<uint8_t> &bus,bool bulk,uint32_t &mine)
+{
+    int rounds = 0;
+    BenchMine = 0;
+    BenchClock_t::time_point start = BenchClock_t::now();
+    double seconds;
+    do {
+        if (bulk)
+            xRdlcReadBytes(handle,(uint8_t*)bus.data(),bus.size());
+        else
+            for (uint8_t byte : bus)
+                xRdlcReadByte(handle,byte);
+        rounds++;
+        seconds = std::chrono::duration<double>(BenchClock_t::now() - start).count();
+    } while (seconds < 0.3);
+    mine = BenchMine / rounds;
+    return seconds * 1e9 / ((double)bus.size() * rounds);
+}
+
+int main(int argc,char *argv[])
+{
+    const uint16_t payloadSizes[] = {16,64,256,1024};
+    RdlcAddrFilter_t filter = {RDLC_ADDR_FILTER_EXACT,BENCH_SELF,0,{0}};
+
+    printf("RDLC RX on a shared bus with %d nodes, ns per byte\n",BENCH_NODES);
+    printf("%8s %12s %12s %8s %12s %12s %8s\n","payload","bulk all","bulk filter","ratio","byte all","byte filter","ratio");
+    for (uint16_t payloadSize : payloadSizes) {
+        Rdlc_t txHandle = RdlcBenchCreate(payloadSize,NULL);
+        Rdlc_t allHandle = RdlcBenchCreate(payloadSize,NULL);
+        Rdlc_t filterHandle = RdlcBenchCreate(payloadSize,&filter);
+        std::mt19937 rng(payloadSize);
+        std::vector<uint8_t> payload(payloadSize);
+        std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(payloadSize,payloadSize));
+        std::vector<uint8_t> bus;
+        while (bus.size() < (1u << 20)) {
+            for (auto &b : payload)
+                b = (uint8_t)rng();
+            RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = (uint8_t)(rng() % BENCH_NODES)};
+            int len = xRdlcWriteBytes(txHandle,addr,payload.data(),payload.size(),frame.data(),frame.size());
+            bus.insert(bus.end(),frame.begin(),frame.begin() + len);
+        }
+
+        uint32_t mineAll, mineFilter;
+        double bulkAll = RdlcBenchNsPerByte(allHandle,bus,true,mineAll);
+        double bulkFilter = RdlcBenchNsPerByte(filterHandle,bus,true,mineFilter);
+        if (mineAll != mineFilter)
+            printf("rdlc: frame count mismatch %u vs %u\n",mineAll,mineFilter);
+        double byteAll = RdlcBenchNsPerByte(allHandle,bus,false,mineAll);
+        double byteFilter = RdlcBenchNsPerByte(filterHandle,bus,false,mineFilter);
+        if (mineAll != mineFilter)
+            printf("rdlc: frame count mismatch %u vs %u\n",mineAll,mineFilter);
+
+        printf("%8u %12.3f %12.3f %7.2fx %12.3f %12.3f %7.2fx\n",payloadSize,
+               bulkAll,bulkFilter,bulkAll / bulkFilter,byteAll,byteFilter,byteAll / byteFilter);
+        vRdlcDestroy(txHandle);
+        vRdlcDestroy(allHandle);
+        vRdlcDestroy(filterHandle);
+    }
+    return 0;
+}
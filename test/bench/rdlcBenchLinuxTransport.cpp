@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "rdlc.h"
+#include "rdlc_linux.h"
+
+/**
+ *@brief ܲԣLinuxepollio_uring˵ÿ֡ϵͳôÿMBCPUʱ
+ *
+ * һԭʼģʽαնˣ豸һ˷ͣ豸һ˽գ˹ͬһһ߳
+ * ÿһ֡кֱһȫģһִ·Ļѹ
+ * ϵͳãepollͳepoll_waitreadwriteio_uringͳio_uring_enter
+ * CPUʱȡgetrusageû̬ں̬ʱ䣬αնںеĿ
+**/
+
+typedef std::chrono::steady_clock BenchClock_t;
+
+static size_t BenchReceived;
+
+extern "C" int RdlcBenchCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    BenchReceived++;
+    return 0;
+}
+
+static bool RdlcBenchOpenPty(int fd[2])
+{
+    fd[0] = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd[0] < 0 || grantpt(fd[0]) != 0 || unlockpt(fd[0]) != 0)
+        return false;
+    fd[1] = open(ptsname(fd[0]),O_RDWR | O_NOCTTY);
+    if (fd[1] < 0)
+        return false;
+    struct termios tty;
+    tcgetattr(fd[1],&tty);
+    cfmakeraw(&tty);
+    return tcsetattr(fd[1],TCSANOW,&tty) == 0;
+}
+
+static double RdlcBenchCpuSeconds(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF,&usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+struct RdlcBenchResult_t
+{
+    double syscallsPerFrame;
+    double cpuMsPerMB;
+    double MBps;
+};
+
+/**
+ *@brief ͬһֺˣBackendṩAdd/Send/Run/Remove/Syscalls
+**/
+template <typename Backend>
+static bool RdlcBenchRun(Backend &backend,uint16_t payloadSize,size_t frames,size_t burst,RdlcBenchResult_t &result)
+{
+    int fds[2];
+    if (!RdlcBenchOpenPty(fds))
+        return false;
+    RdlcConfig_t config = {
+        .msgMaxSize = payloadSize,
+        .msgMaxEscapeSize = payloadSize,
+        .cbParsed = RdlcBenchCallback,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t txHandle = xRdlcCreate(&config,&port);
+    Rdlc_t rxHandle = xRdlcCreate(&config,&port);
+    std::vector<uint8_t> txQueue(burst * RDLC_GET_FRAME_SIZE(payloadSize,payloadSize));
+    std::vector<uint8_t> rxQueue(64);
+    RdlcLinuxLink_t txLink, rxLink;
+    RdlcLinuxLinkConfig_t txConfig = {fds[0],txHandle,txQueue.data(),txQueue.size(),NULL};
+    RdlcLinuxLinkConfig_t rxConfig = {fds[1],rxHandle,rxQueue.data(),rxQueue.size(),NULL};
+    if (!txHandle || !rxHandle || backend.Add(&txLink,&txConfig) != RDLC_OK || backend.Add(&rxLink,&rxConfig) != RDLC_OK)
+        return false;
+
+    std::vector<uint8_t> payload(payloadSize);
+    for (size_t i = 0; i < payload.size(); i++)
+        payload[i] = (uint8_t)rand();
+    RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+
+    BenchReceived = 0;
+    uint64_t syscalls = backend.Syscalls(&txLink,&rxLink);
+    double cpu = RdlcBenchCpuSeconds();
+    BenchClock_t::time_point start = BenchClock_t::now();
+    for (size_t sent = 0; sent < frames; sent += burst) {
+        for (size_t i = 0; i < burst; i++)
+            backend.Send(&txLink,addr,payload.data(),payload.size());
+        while (BenchReceived < sent + burst)
+            backend.Run(100);
+    }
+    double seconds = std::chrono::duration<double>(BenchClock_t::now() - start).count();
+    cpu = RdlcBenchCpuSeconds() - cpu;
+    syscalls = backend.Syscalls(&txLink,&rxLink) - syscalls;
+
+    double MB = (double)frames * payloadSize / 1e6;
+    result.syscallsPerFrame = (double)syscalls / frames;
+    result.cpuMsPerMB = cpu * 1e3 / MB;
+    result.MBps = MB / seconds;
+
+    backend.Remove(&txLink);
+    backend.Remove(&rxLink);
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rxHandle);
+    close(fds[0]);
+    close(fds[1]);
+    return true;
+}
+
+struct RdlcBenchEpoll_t
+{
+    RdlcLinuxLoop_t loop;
+    int Add(RdlcLinuxLink_t *link,const RdlcLinuxLinkConfig_t *config) { return xRdlcLinuxLinkAdd(&loop,link,config); }
+    int Send(RdlcLinuxLink_t *link,RdlcAddr_t addr,const uint8_t *payload,size_t size) { return xRdlcLinuxSend(&loop,link,addr,payload,size); }
+    int Run(int timeoutMs) { return xRdlcLinuxLoopRun(&loop,timeoutMs); }
+    int Remove(RdlcLinuxLink_t *link) { return xRdlcLinuxLinkRemove(&loop,link); }
+    uint64_t Syscalls(RdlcLinuxLink_t *a,RdlcLinuxLink_t *b) {
+        return loop.waitSyscalls + a->rxSyscalls + a->txSyscalls + b->rxSyscalls + b->txSyscalls;
+    }
+};
+
+struct RdlcBenchUring_t
+{
+    RdlcLinuxUring_t ring;
+    int Add(RdlcLinuxLink_t *link,const RdlcLinuxLinkConfig_t *config) { return xRdlcLinuxUringLinkAdd(&ring,link,config); }
+    int Send(RdlcLinuxLink_t *link,RdlcAddr_t addr,const uint8_t *payload,size_t size) { return xRdlcLinuxUringSend(&ring,link,addr,payload,size); }
+    int Run(int timeoutMs) { return xRdlcLinuxUringRun(&ring,timeoutMs); }
+    int Remove(RdlcLinuxLink_t *link) { return xRdlcLinuxUringLinkRemove(&ring,link); }
+    uint64_t Syscalls(RdlcLinuxLink_t *a,RdlcLinuxLink_t *b) { return ring.enterSyscalls; }
+};
+
+int main(int argc,char *argv[])
+{
+    const uint16_t payloadSizes[] = {16,64,256,1024};
+    const size_t bytesPerCase = 16u << 20;
+    const size_t burst = 16;
+
+    static uint8_t rxBuf[RDLC_LINUX_RX_BUF_SIZE];
+    static RdlcBenchEpoll_t epoll;
+    if (xRdlcLinuxLoopInit(&epoll.loop,rxBuf,sizeof(rxBuf)) != RDLC_OK) {
+        printf("rdlc: epoll init failed\n");
+        return 1;
+    }
+    static uint8_t rxBufs[RDLC_LINUX_URING_RX_BUF_COUNT][RDLC_LINUX_URING_RX_BUF_SIZE];
+    static RdlcBenchUring_t uring;
+    bool uringOk = xRdlcLinuxUringInit(&uring.ring,&rxBufs[0][0],RDLC_LINUX_URING_RX_BUF_SIZE,RDLC_LINUX_URING_RX_BUF_COUNT) == RDLC_OK;
+    if (!uringOk)
+        printf("rdlc: io_uring not available, only epoll is measured\n");
+
+    printf("RDLC Linux transport over a pty pair, %u frames per burst: epoll vs io_uring\n",(unsigned)burst);
+    printf("%8s %13s %13s %11s %13s %13s %11s\n","payload","epoll sys/fr","epoll ms/MB","epoll MB/s","uring sys/fr","uring ms/MB","uring MB/s");
+    for (uint16_t payloadSize : payloadSizes) {
+        size_t frames = bytesPerCase / payloadSize / burst * burst;
+        if (frames > 200000)
+            frames = 200000 / burst * burst;
+        RdlcBenchResult_t e = {}, u = {};
+        if (!RdlcBenchRun(epoll,payloadSize,frames,burst,e)) {
+            printf("rdlc: epoll run failed\n");
+            return 1;
+        }
+        if (uringOk && !RdlcBenchRun(uring,payloadSize,frames,burst,u)) {
+            printf("rdlc: io_uring run failed\n");
+            return 1;
+        }
+        printf("%8u %13.3f %13.1f %11.1f %13.3f %13.1f %11.1f\n",payloadSize,
+               e.syscallsPerFrame,e.cpuMsPerMB,e.MBps,u.syscallsPerFrame,u.cpuMsPerMB,u.MBps);
+    }
+    if (uringOk)
+        printf("io_uring multishot read: %s\n",uring.ring.multishot ? "yes" : "no (one-shot reads)");
+
+    vRdlcLinuxLoopDeinit(&epoll.loop);
+    if (uringOk)
+        vRdlcLinuxUringDeinit(&uring.ring);
+    return 0;
+}
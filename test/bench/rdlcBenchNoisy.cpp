@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "rdlc.h"
+
+/**
+ *@brief ܲԣŵϣÿһ֡õ֡
+ *
+ * Ͷȵ֡ÿ֡һʱ𻵡ն˷ַʽ룺
+ *   byte  ֽxRdlcReadByteÿֽڴһεĴڽжһ
+ *   bulk  ÿ256ֽxRdlcReadBytesDMAжϡLinuxһ֡Ӧͬһк֡
+ * 𻵷ʽ
+ *   cut   Ͷ֡м䱻λһ֡ʣµֽûзȥžһ֡
+ *   tail  Ͷ֡мһ֡֡βٷһ֡նյǰ֡βRDLC_ERR_CRC
+ *   flip  ֡һֽڱĳɱֵڳֶλתַ
+ *   noise ֡λò1~16ֽ
+ * غǰ4ֽ֡ţصк˶غɡ֡յƽÿ֡֡
+ * ԼCRCͨȴԵ֡
+**/
+
+#define BENCH_FRAMES     20000
+#define BENCH_MSG_SIZE   256
+#define BENCH_CHUNK_SIZE 256
+
+static std::vector<std::vector<uint8_t>> BenchPayloads;
+static std::vector<uint8_t> BenchDelivered;
+static uint32_t BenchBogus;
+
+extern "C" int RdlcBenchCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    uint32_t seq;
+    if (size < sizeof(seq)) {
+        BenchBogus++;
+        return 0;
+    }
+    memcpy(&seq,data,sizeof(seq));
+    if (seq >= BenchPayloads.size() || BenchPayloads[seq].size() != size || memcmp(BenchPayloads[seq].data(),data,size) != 0) {
+        BenchBogus++;
+        return 0;
+    }
+    BenchDelivered[seq] = 1;
+    return 0;
+}
+
+enum RdlcBenchCorrupt_t
+{
+    BENCH_CORRUPT_CUT,
+    BENCH_CORRUPT_TAIL,
+    BENCH_CORRUPT_FLIP,
+    BENCH_CORRUPT_NOISE,
+};
+
+static void RdlcBenchRunCase(Rdlc_t txHandle,Rdlc_t rxHandle,RdlcBenchCorrupt_t mode,int percent,bool bulk)
+{
+    std::mt19937 rng(mode * 100 + percent);
+    std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(BENCH_MSG_SIZE,BENCH_MSG_SIZE));
+    std::vector<uint8_t> corrupted(BENCH_FRAMES);
+    std::vector<uint8_t> line;
+    RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+
+    BenchPayloads.assign(BENCH_FRAMES,std::vector<uint8_t>());
+    BenchDelivered.assign(BENCH_FRAMES,0);
+    BenchBogus = 0;
+    for (uint32_t seq = 0; seq < BENCH_FRAMES; seq++) {
+        std::vector<uint8_t> &payload = BenchPayloads[seq];
+        payload.resize(16 + rng() % (BENCH_MSG_SIZE - 15));
+        for (auto &b : payload)
+            b = (uint8_t)rng();
+        memcpy(payload.data(),&seq,sizeof(seq));
+        int len = xRdlcWriteBytes(txHandle,addr,payload.data(),payload.size(),frame.data(),frame.size());
+        if (len <= 0) {
+            printf("rdlc: write failed %d\n",len);
+            exit(1);
+        }
+
+        std::vector<uint8_t> wire(frame.begin(),frame.begin() + len);
+        if ((int)(rng() % 100) < percent) {
+            corrupted[seq] = 1;
+            size_t pos = 2 + rng() % (wire.size() - 4);
+            switch (mode) {
+                case BENCH_CORRUPT_CUT:
+                    wire.resize(pos);
+                break;
+                case BENCH_CORRUPT_TAIL:
+                    wire.resize(pos);
+                    wire.insert(wire.end(),{0xFF,0x0C});
+                break;
+                case BENCH_CORRUPT_FLIP:
+                    wire[pos] ^= (uint8_t)(1 + rng() % 255);
+                break;
+                case BENCH_CORRUPT_NOISE:
+                    for (int n = 1 + rng() % 16; n > 0; n--)
+                        wire.insert(wire.begin() + pos,(uint8_t)rng());
+                break;
+            }
+        }
+        line.insert(line.end(),wire.begin(),wire.end());
+    }
+
+    if (bulk) {
+        for (size_t pos = 0; pos < line.size(); pos += BENCH_CHUNK_SIZE)
+            xRdlcReadBytes(rxHandle,&line[pos],std::min<size_t>(BENCH_CHUNK_SIZE,line.size() - pos));
+    }
+    else {
+        for (uint8_t byte : line)
+            xRdlcReadByte(rxHandle,byte);
+    }
+
+    uint32_t corrupt = 0, clean = 0, cleanDelivered = 0;
+    for (uint32_t seq = 0; seq < BENCH_FRAMES; seq++) {
+        if (corrupted[seq])
+            corrupt++;
+        else {
+            clean++;
+            cleanDelivered += BenchDelivered[seq];
+        }
+    }
+    static const char *names[] = {"cut","tail","flip","noise"};
+    printf("%6s %5s %6d%% %8u %8u %9.2f%% %12.3f %8u\n",names[mode],bulk ? "bulk" : "byte",percent,corrupt,clean,
+           clean ? 100.0 * cleanDelivered / clean : 0.0,
+           corrupt ? (double)(clean - cleanDelivered) / corrupt : 0.0,BenchBogus);
+}
+
+int main(int argc,char *argv[])
+{
+    RdlcConfig_t config = {
+        .msgMaxSize = BENCH_MSG_SIZE,
+        .msgMaxEscapeSize = BENCH_MSG_SIZE,
+        .cbParsed = RdlcBenchCallback,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+
+    const RdlcBenchCorrupt_t modes[] = {BENCH_CORRUPT_CUT,BENCH_CORRUPT_TAIL,BENCH_CORRUPT_FLIP,BENCH_CORRUPT_NOISE};
+    const int percents[] = {1,5,20};
+
+    printf("RDLC noisy channel: %u frames per case, payload 16~%u bytes, fed byte by byte or in %u-byte chunks\n",BENCH_FRAMES,BENCH_MSG_SIZE,BENCH_CHUNK_SIZE);
+    printf("%6s %5s %7s %8s %8s %10s %12s %8s\n","mode","feed","rate","corrupt","clean","goodput","lost/corrupt","bogus");
+    for (RdlcBenchCorrupt_t mode : modes)
+    for (int bulk = 0; bulk < 2; bulk++)
+        for (int percent : percents) {
+            Rdlc_t txHandle = xRdlcCreate(&config,&port);
+            Rdlc_t rxHandle = xRdlcCreate(&config,&port);
+            if (!txHandle || !rxHandle) {
+                printf("rdlc: init handle failed\n");
+                return 1;
+            }
+            RdlcBenchRunCase(txHandle,rxHandle,mode,percent,bulk);
+            vRdlcDestroy(txHandle);
+            vRdlcDestroy(rxHandle);
+        }
+    return 0;
+}
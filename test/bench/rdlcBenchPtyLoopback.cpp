@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <string>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "rdlc.h"
+
+/**
+ *@brief ܲԣαն˻ػ˵˵ºӳ
+ *
+ * һԭʼģʽαն˴һԴڣ߳豸һ˷д룬߳ڴ豸һ˶
+ * غǰ4ֽ֡ţʱʱ̣صȡӳ٣ӿʼ͵صʱ䡣
+ * ѡ
+ *   --baud N    ģNʵ8N1ڣÿ֡Ҫһ֡""ſʼдǰȴ֡*10/N룬ӳаʱ
+ *   --window N  N֡;дȽն׷ϣȡ0ƣʱӳҪαն˻еŶʱ
+ *   --seconds S ÿغɳȺתܶȲS
+ * ÿ֡ÿغMBЧغռֽڵıԼصӳٵp50/p99/p999
+**/
+
+typedef std::chrono::steady_clock BenchClock_t;
+
+#define BENCH_STAMP_RING (1u << 16) ///< ʱ̰ȡģţ;֡ԶСڴֵ
+
+static std::atomic<int64_t> BenchSendStamp[BENCH_STAMP_RING];
+static std::vector<double> BenchLatencyUs;
+static std::atomic<uint32_t> BenchReceived;
+
+static int64_t RdlcBenchNowNs(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock_t::now().time_since_epoch()).count();
+}
+
+extern "C" int RdlcBenchCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    int64_t now = RdlcBenchNowNs();
+    uint32_t seq;
+    memcpy(&seq,data,sizeof(seq));
+    BenchLatencyUs.push_back((now - BenchSendStamp[seq % BENCH_STAMP_RING].load(std::memory_order_relaxed)) / 1e3);
+    BenchReceived.fetch_add(1,std::memory_order_release);
+    return 0;
+}
+
+static bool RdlcBenchOpenPty(int fd[2])
+{
+    fd[0] = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd[0] < 0 || grantpt(fd[0]) != 0 || unlockpt(fd[0]) != 0)
+        return false;
+    fd[1] = open(ptsname(fd[0]),O_RDWR | O_NOCTTY);
+    if (fd[1] < 0)
+        return false;
+    struct termios tty;
+    tcgetattr(fd[1],&tty);
+    cfmakeraw(&tty);
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
+    return tcsetattr(fd[1],TCSANOW,&tty) == 0;
+}
+
+struct RdlcBenchCase_t
+{
+    uint16_t payloadSize;
+    int escapePermille;  ///< غ0xFFıǧ֮ȡ-1Ϊֽ
+};
+
+struct RdlcBenchOptions_t
+{
+    uint32_t baud;
+    uint32_t window;
+    double seconds;
+};
+
+static double RdlcBenchPercentile(std::vector<double> &sorted,double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t index = (size_t)(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+static void RdlcBenchRunCase(const RdlcBenchCase_t &c,const RdlcBenchOptions_t &options)
+{
+    int fds[2];
+    if (!RdlcBenchOpenPty(fds)) {
+        printf("rdlc: openpty failed\n");
+        exit(1);
+    }
+    const uint16_t msgMaxSize = 4096;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = RdlcBenchCallback,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t txHandle = xRdlcCreate(&config,&port);
+    Rdlc_t rxHandle = xRdlcCreate(&config,&port);
+    if (!txHandle || !rxHandle) {
+        printf("rdlc: init handle failed\n");
+        exit(1);
+    }
+
+    // Ԥغɣʱֻд
+    std::mt19937 rng(c.payloadSize * 1000 + c.escapePermille);
+    std::vector<uint8_t> payload(c.payloadSize);
+    for (auto &b : payload) {
+        if (c.escapePermille < 0)
+            b = (uint8_t)rng();
+        else
+            b = ((int)(rng() % 1000) < c.escapePermille) ? 0xFF : (uint8_t)(rng() % 255);
+    }
+
+    BenchLatencyUs.clear();
+    BenchLatencyUs.reserve(1 << 20);
+    BenchReceived = 0;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> sent(0);
+    uint64_t wireBytes = 0;
+
+    std::thread reader([&]() {
+        static uint8_t buf[1 << 16];
+        struct pollfd pfd = {fds[1],POLLIN,0};
+        while (true) {
+            if (done.load(std::memory_order_acquire) && BenchReceived.load() == sent.load())
+                break;
+            if (poll(&pfd,1,200) <= 0) {
+                if (done.load(std::memory_order_acquire))
+                    break; // ʣµ֡
+                continue;
+            }
+            ssize_t n = read(fds[1],buf,sizeof(buf));
+            if (n <= 0)
+                break;
+            xRdlcReadBytes(rxHandle,buf,(size_t)n);
+        }
+    });
+
+    std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(msgMaxSize,msgMaxSize));
+    RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+    BenchClock_t::time_point start = BenchClock_t::now();
+    BenchClock_t::time_point deadline = start + std::chrono::duration_cast<BenchClock_t::duration>(std::chrono::duration<double>(options.seconds));
+    BenchClock_t::time_point lineFree = start;
+    uint32_t seq = 0;
+    while (BenchClock_t::now() < deadline) {
+        while (options.window && (seq - BenchReceived.load(std::memory_order_acquire) >= options.window))
+            std::this_thread::yield();
+        memcpy(payload.data(),&seq,sizeof(seq));
+        int len = xRdlcWriteBytes(txHandle,addr,payload.data(),payload.size(),frame.data(),frame.size());
+        if (len <= 0) {
+            printf("rdlc: write failed %d\n",len);
+            exit(1);
+        }
+
+        BenchClock_t::time_point now = BenchClock_t::now();
+        if (options.baud) {
+            // һ֡ûʱ棬һ֡ȫ""Žαն
+            BenchClock_t::time_point begin = std::max(now,lineFree);
+            lineFree = begin + std::chrono::duration_cast<BenchClock_t::duration>(std::chrono::duration<double>(len * 10.0 / options.baud));
+            BenchSendStamp[seq % BENCH_STAMP_RING].store(std::chrono::duration_cast<std::chrono::nanoseconds>(begin.time_since_epoch()).count(),std::memory_order_relaxed);
+            std::this_thread::sleep_until(lineFree);
+        }
+        else
+            BenchSendStamp[seq % BENCH_STAMP_RING].store(RdlcBenchNowNs(),std::memory_order_relaxed);
+
+        for (int off = 0; off < len;) {
+            ssize_t n = write(fds[0],&frame[off],len - off);
+            if (n <= 0) {
+                printf("rdlc: pty write failed\n");
+                exit(1);
+            }
+            off += n;
+        }
+        wireBytes += len;
+        seq++;
+        sent.store(seq,std::memory_order_release);
+    }
+    done.store(true,std::memory_order_release);
+    reader.join();
+    double seconds = std::chrono::duration<double>(BenchClock_t::now() - start).count();
+
+    uint32_t received = BenchReceived.load();
+    std::sort(BenchLatencyUs.begin(),BenchLatencyUs.end());
+    char density[16];
+    if (c.escapePermille < 0)
+        snprintf(density,sizeof(density),"random");
+    else
+        snprintf(density,sizeof(density),"%.1f%%",c.escapePermille / 10.0);
+    printf("%8u %8s %12.0f %10.3f %9.1f%% %10.1f %10.1f %10.1f %8u\n",c.payloadSize,density,
+           received / seconds,(double)received * c.payloadSize / seconds / 1e6,
+           wireBytes ? 100.0 * (double)seq * c.payloadSize / wireBytes : 0.0,
+           RdlcBenchPercentile(BenchLatencyUs,0.5),RdlcBenchPercentile(BenchLatencyUs,0.99),RdlcBenchPercentile(BenchLatencyUs,0.999),
+           seq - received);
+
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rxHandle);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+int main(int argc,char *argv[])
+{
+    RdlcBenchOptions_t options = {.baud = 0, .window = 8, .seconds = 1.0};
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            printf("usage: %s [--baud N] [--window N] [--seconds S]\n",argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i],"--baud") == 0)
+            options.baud = (uint32_t)strtoul(argv[i + 1],NULL,10);
+        else if (strcmp(argv[i],"--window") == 0)
+            options.window = (uint32_t)strtoul(argv[i + 1],NULL,10);
+        else if (strcmp(argv[i],"--seconds") == 0)
+            options.seconds = atof(argv[i + 1]);
+        else {
+            printf("usage: %s [--baud N] [--window N] [--seconds S]\n",argv[0]);
+            return 1;
+        }
+    }
+
+    const uint16_t payloadSizes[] = {16,64,256,1024,4096};
+    const int escapePermilles[] = {0,-1,100,500};
+
+    printf("RDLC pty loopback: baud %s, window %u, %.1fs per case\n",
+           options.baud ? std::to_string(options.baud).c_str() : "unlimited",options.window,options.seconds);
+    printf("%8s %8s %12s %10s %10s %10s %10s %10s %8s\n","payload","0xFF","frames/s","MB/s","goodput","p50(us)","p99(us)","p999(us)","lost");
+    for (int escape : escapePermilles)
+        for (uint16_t payloadSize : payloadSizes)
+            RdlcBenchRunCase({payloadSize,escape},options);
+    return 0;
+}
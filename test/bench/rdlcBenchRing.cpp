@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "rdlc.h"
+
+/**
+ *@brief ܲԣߵֽڻ
+ *
+ * 1. ֽ߳ͨڻֽÿд1(xRdlcRingPushByte)256ֽڣÿMB
+ *    RDLC_CACHE_LINE_SIZE=4benchRingPackedߺߵĳԱͬһУԱαĿ
+ * 2. ߳̽ģжϺжֽдõ֡xRdlcRingDrain
+ *    ֱͳÿֽڵĺʱжֱӵxRdlcReadByteԱȡ
+**/
+
+typedef std::chrono::steady_clock BenchClock_t;
+
+static volatile uint32_t BenchFrames;
+
+extern "C" int RdlcBenchCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    BenchFrames = BenchFrames + 1;
+    return 0;
+}
+
+static double RdlcBenchSeconds(BenchClock_t::time_point start)
+{
+    return std::chrono::duration<double>(BenchClock_t::now() - start).count();
+}
+
+static double RdlcBenchThreads(uint32_t chunk,uint32_t ringSize,uint64_t total)
+{
+    std::vector<uint8_t> buffer(ringSize);
+    static RdlcRing_t ring;
+    xRdlcRingInit(&ring,buffer.data(),ringSize);
+    BenchClock_t::time_point start = BenchClock_t::now();
+    std::thread producer([&]() {
+        uint8_t data[256];
+        for (uint32_t i = 0; i < sizeof(data); i++)
+            data[i] = (uint8_t)i;
+        uint64_t sent = 0;
+        while (sent < total) {
+            uint32_t count;
+            if (chunk == 1)
+                count = (xRdlcRingPushByte(&ring,(uint8_t)sent) == RDLC_OK);
+            else
+                count = xRdlcRingPush(&ring,data,chunk);
+            if (count == 0)
+                std::this_thread::yield();
+            sent += count;
+        }
+    });
+    uint64_t received = 0;
+    uint32_t sum = 0;
+    while (received < total) {
+        const uint8_t *data;
+        uint32_t size = xRdlcRingPeek(&ring,&data);
+        if (size == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < size; i++)
+            sum += data[i];
+        vRdlcRingConsume(&ring,size);
+        received += size;
+    }
+    producer.join();
+    double seconds = RdlcBenchSeconds(start);
+    if (sum == 1)
+        printf(" ");
+    return total / seconds / 1e6;
+}
+
+static Rdlc_t RdlcBenchCreate(uint16_t msgMaxSize)
+{
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = RdlcBenchCallback,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    return xRdlcCreate(&config,&port);
+}
+
+static void RdlcBenchIsr(uint16_t payloadSize,uint32_t ringSize)
+{
+    Rdlc_t txHandle = RdlcBenchCreate(payloadSize);
+    Rdlc_t rxHandle = RdlcBenchCreate(payloadSize);
+    std::mt19937 rng(payloadSize);
+    std::vector<uint8_t> payload(payloadSize);
+    for (auto &b : payload)
+        b = (uint8_t)rng();
+    std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(payloadSize,payloadSize));
+    RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+    int len = xRdlcWriteBytes(txHandle,addr,payload.data(),payload.size(),frame.data(),frame.size());
+    std::vector<uint8_t> stream;
+    while (stream.size() < (8u << 20))
+        stream.insert(stream.end(),frame.begin(),frame.begin() + len);
+
+    // ֱжнÿֽڶҪһ״̬֡βֽڻҪУCRCִлص
+    BenchFrames = 0;
+    BenchClock_t::time_point start = BenchClock_t::now();
+    for (uint8_t byte : stream)
+        xRdlcReadByte(rxHandle,byte);
+    double direct = RdlcBenchSeconds(start);
+    uint32_t directFrames = BenchFrames;
+
+    // жֻдֽڻ
+    std::vector<uint8_t> buffer(ringSize);
+    RdlcRing_t ring;
+    xRdlcRingInit(&ring,buffer.data(),ringSize);
+    BenchFrames = 0;
+    double isr = 0, task = 0;
+    for (size_t i = 0; i < stream.size();) {
+        size_t end = std::min(stream.size(),i + ringSize / 2);
+        start = BenchClock_t::now();
+        for (; i < end; i++)
+            xRdlcRingPushByte(&ring,stream[i]);
+        isr += RdlcBenchSeconds(start);
+        start = BenchClock_t::now();
+        xRdlcRingDrain(rxHandle,&ring);
+        task += RdlcBenchSeconds(start);
+    }
+    if (BenchFrames != directFrames)
+        printf("rdlc: frame count mismatch %u vs %u\n",BenchFrames,directFrames);
+
+    double bytes = (double)stream.size();
+    printf("%8u %16.2f %14.2f %14.2f %14.2f\n",payloadSize,direct * 1e9 / bytes,isr * 1e9 / bytes,task * 1e9 / bytes,(isr + task) * 1e9 / bytes);
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rxHandle);
+}
+
+int main(int argc,char *argv[])
+{
+    const uint32_t chunks[] = {1,16,64,256};
+    const uint32_t ringSizes[] = {256,4096};
+    const uint64_t total = 64u << 20;
+
+    printf("RDLC SPSC byte ring, RDLC_CACHE_LINE_SIZE %d, %u CPUs\n",RDLC_CACHE_LINE_SIZE,std::thread::hardware_concurrency());
+    printf("two threads, MB/s\n%8s","chunk");
+    for (uint32_t ringSize : ringSizes)
+        printf(" %10s%-5u","ring ",ringSize);
+    printf("\n");
+    for (uint32_t chunk : chunks) {
+        printf("%8u",chunk);
+        for (uint32_t ringSize : ringSizes)
+            printf(" %15.1f",RdlcBenchThreads(chunk,ringSize,chunk == 1 ? total / 4 : total));
+        printf("\n");
+    }
+
+    printf("\nISR handoff, ns per byte, ring 1024\n");
+    printf("%8s %16s %14s %14s %14s\n","payload","ReadByte in ISR","ring push","ring drain","push+drain");
+    const uint16_t payloadSizes[] = {16,64,256,1024};
+    for (uint16_t payloadSize : payloadSizes)
+        RdlcBenchIsr(payloadSize,1024);
+    return 0;
+}
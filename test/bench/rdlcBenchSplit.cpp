@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "rdlc.h"
+
+/**
+ *@brief ܲԣжÿֽڵʱֱӵxRdlcReadByteֶνյжϲԱ
+ *
+ * ͬһ֡ظΣÿֽλȡеСʱųϵͳжϺͻĸţ
+ * ȡֽλеֵΪʱֱӽʱ֡β(УCRCִлص)ֶνʱλ޹ء
+ * صغɿӦûһ򵥵û
+ * x86TSCڼʱƽ̨ʱRDLC_CRC16_INCREMENTAL=0benchSplitCrcAtTailУ֡βҪһԼغɵCRC
+**/
+
+static uint8_t BenchApp[65536];
+
+extern "C" int RdlcBenchCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    memcpy(BenchApp,data,size);
+    return 0;
+}
+
+static inline uint64_t RdlcBenchTicks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static Rdlc_t RdlcBenchCreate(uint16_t msgMaxSize)
+{
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = RdlcBenchCallback,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    return xRdlcCreate(&config,&port);
+}
+
+struct RdlcBenchCost_t
+{
+    double mean;
+    uint64_t worst;
+};
+
+/**
+ *@brief ÿֽλȡrepeatеСʱƽֵֵ
+**/
+template <typename Step,typename Between>
+static RdlcBenchCost_t RdlcBenchMeasure(const std::vector<uint8_t> &stream,int repeat,uint64_t overhead,Step step,Between between)
+{
+    std::vector<uint64_t> best(stream.size(),UINT64_MAX);
+    for (int r = 0; r < repeat; r++) {
+        for (size_t i = 0; i < stream.size(); i++) {
+            uint64_t t0 = RdlcBenchTicks();
+            step(stream[i]);
+            uint64_t t1 = RdlcBenchTicks();
+            best[i] = std::min(best[i],t1 - t0);
+        }
+        between();
+    }
+    RdlcBenchCost_t cost = {0,0};
+    for (uint64_t b : best) {
+        b = (b > overhead) ? b - overhead : 0;
+        cost.mean += b;
+        cost.worst = std::max(cost.worst,b);
+    }
+    cost.mean /= stream.size();
+    return cost;
+}
+
+int main(int argc,char *argv[])
+{
+    const uint16_t payloadSizes[] = {16,64,256,1024,4096};
+    const int repeat = 200;
+
+    uint64_t overhead = UINT64_MAX;
+    for (int i = 0; i < 100000; i++) {
+        uint64_t t0 = RdlcBenchTicks();
+        uint64_t t1 = RdlcBenchTicks();
+        overhead = std::min(overhead,t1 - t0);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    const char *unit = "cycles";
+#else
+    const char *unit = "ns";
+#endif
+    printf("RDLC ISR cost per byte (%s, timer overhead %llu subtracted), CRC %s\n",unit,(unsigned long long)overhead,
+           RDLC_CRC16_INCREMENTAL ? "incremental" : "at tail");
+    printf("%8s %14s %14s %14s %14s %16s\n","payload","ReadByte mean","ReadByte worst","split mean","split worst","split task/frame");
+    for (uint16_t payloadSize : payloadSizes) {
+        Rdlc_t txHandle = RdlcBenchCreate(payloadSize);
+        Rdlc_t rxHandle = RdlcBenchCreate(payloadSize);
+        std::mt19937 rng(payloadSize);
+        std::vector<uint8_t> payload(payloadSize);
+        for (auto &b : payload)
+            b = (uint8_t)rng();
+        std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(payloadSize,payloadSize));
+        RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+        int len = xRdlcWriteBytes(txHandle,addr,payload.data(),payload.size(),frame.data(),frame.size());
+        std::vector<uint8_t> stream;
+        while (stream.size() < 16384 || stream.size() < (size_t)len * 4)
+            stream.insert(stream.end(),frame.begin(),frame.begin() + len);
+        size_t frames = stream.size() / len;
+
+        RdlcBenchCost_t direct = RdlcBenchMeasure(stream,repeat,overhead,
+            [&](uint8_t byte) { xRdlcReadByte(rxHandle,byte); },[]() {});
+
+        std::vector<uint8_t> slots(frames * RDLC_SPLIT_SLOT_SIZE(payloadSize));
+        RdlcSplitRxConfig_t config = {slots.data(),(uint16_t)RDLC_SPLIT_SLOT_SIZE(payloadSize),1};
+        while (config.slotCount < frames)
+            config.slotCount <<= 1;
+        slots.resize((size_t)config.slotCount * config.slotSize);
+        config.slots = slots.data();
+        RdlcSplitRx_t split;
+        xRdlcSplitRxInit(rxHandle,&split,&config);
+        uint64_t taskTicks = UINT64_MAX;
+        RdlcBenchCost_t isr = RdlcBenchMeasure(stream,repeat,overhead,
+            [&](uint8_t byte) { xRdlcSplitRxIsrByte(&split,byte); },
+            [&]() {
+                uint64_t t0 = RdlcBenchTicks();
+                xRdlcSplitRxPoll(&split);
+                taskTicks = std::min(taskTicks,RdlcBenchTicks() - t0);
+            });
+        if (split.dropped)
+            printf("rdlc: split dropped %u frames\n",split.dropped);
+
+        printf("%8u %14.1f %14llu %14.1f %14llu %16.0f\n",payloadSize,direct.mean,(unsigned long long)direct.worst,
+               isr.mean,(unsigned long long)isr.worst,(double)taskTicks / frames);
+        vRdlcDestroy(txHandle);
+        vRdlcDestroy(rxHandle);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "rdlc.h"
+
+/**
+ *@brief ܲԣ֡βֽڵصӳ
+ *
+ * xRdlcReadBytes֡β֮ǰֽڣٵʱ֡βxRdlcReadByte
+ * ֡βﵽصӳ٣Ҳڴж֡βһεõĺʱ
+ * RDLC_CRC16_INCREMENTAL=1ʱCRCغɵʱۼƣ֡βʱӦغɳ޹أ
+ * ȡ0ʱCRC֡βһԼ㣬ʱغ
+**/
+
+typedef std::chrono::steady_clock BenchClock_t;
+
+static BenchClock_t::time_point CallbackTime;
+
+extern "C" int RdlcBenchCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    CallbackTime = BenchClock_t::now();
+    return 0;
+}
+
+int main(int argc,char *argv[])
+{
+    const uint16_t payloadSizes[] = {16,64,256,1024,4096,16384,60000};
+    const int rounds = 2000;
+
+    printf("RDLC tail-to-callback latency, RDLC_CRC16_INCREMENTAL=%d\n",RDLC_CRC16_INCREMENTAL);
+    printf("%10s %12s %12s %12s %14s\n","payload","p50(ns)","p99(ns)","max(ns)","frame(ns/B)");
+
+    for (uint16_t payloadSize : payloadSizes) {
+        RdlcConfig_t config = {
+            .msgMaxSize = payloadSize,
+            .msgMaxEscapeSize = 0,
+            .cbParsed = RdlcBenchCallback,
+            .cbError = NULL,
+        };
+        RdlcPort_t port = {
+            .portMalloc = malloc,
+            .portFree = free,
+            .portPrintf = NULL
+        };
+        Rdlc_t handle = xRdlcCreate(&config,&port);
+        if (handle == NULL) {
+            printf("rdlc: init handle failed\n");
+            return 1;
+        }
+
+        std::vector<uint8_t> payload(payloadSize);
+        for (size_t i = 0; i < payload.size(); i++)
+            payload[i] = (uint8_t)(rand() % 255);
+        std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(payloadSize,0));
+        RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+        int len = xRdlcWriteBytes(handle,addr,payload.data(),payloadSize,frame.data(),frame.size());
+        if (len <= 0) {
+            printf("rdlc: write failed %d\n",len);
+            return 1;
+        }
+
+        std::vector<double> latency;
+        double frameNs = 0;
+        for (int r = 0; r < rounds; r++) {
+            BenchClock_t::time_point start = BenchClock_t::now();
+            xRdlcReadBytes(handle,frame.data(),len - 1);
+            BenchClock_t::time_point tail = BenchClock_t::now();
+            int err = xRdlcReadByte(handle,frame[len - 1]);
+            if (err != RDLC_OK) {
+                printf("rdlc: read failed %d\n",err);
+                return 1;
+            }
+            latency.push_back(std::chrono::duration<double,std::nano>(CallbackTime - tail).count());
+            frameNs += std::chrono::duration<double,std::nano>(CallbackTime - start).count();
+        }
+        std::sort(latency.begin(),latency.end());
+        printf("%10u %12.0f %12.0f %12.0f %14.3f\n",payloadSize,
+               latency[rounds / 2],latency[rounds * 99 / 100],latency.back(),frameNs / rounds / len);
+
+        vRdlcDestroy(handle);
+    }
+    return 0;
+}
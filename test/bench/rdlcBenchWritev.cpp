@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "rdlc.h"
+
+/**
+ *@brief ܲԣxRdlcWriteBytes + write()  xRdlcWriteIovec + writev() ķͿ
+ *
+ * ֡дһܵһ̲߳ϰѹܵգ൱ں˿ٶ޿Ĵڡ
+ * غǾȷֲֽڣƽÿ256ֽڳһ0xFF
+ * ͳƵǴӷʼwrite/writevصʱ䣬ҲǷ߳ÿ֡Ŀ
+**/
+
+typedef std::chrono::steady_clock BenchClock_t;
+
+static void RdlcBenchDrain(int fd)
+{
+    static uint8_t sink[1 << 16];
+    while (read(fd,sink,sizeof(sink)) > 0) {
+    }
+}
+
+static bool RdlcBenchWriteAll(int fd,const uint8_t *data,size_t size)
+{
+    while (size > 0) {
+        ssize_t n = write(fd,data,size);
+        if (n <= 0)
+            return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool RdlcBenchWritevAll(int fd,struct iovec *iov,int count)
+{
+    while (count > 0) {
+        ssize_t n = writev(fd,iov,count);
+        if (n <= 0)
+            return false;
+        // ܵдʱwritevֻдһ֣ѾдƬ
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+int main(int argc,char *argv[])
+{
+    const uint16_t payloadSizes[] = {64,256,1024,4096,16384,60000};
+    const size_t bytesPerCase = 256u << 20;
+
+    int pipeFd[2];
+    if (pipe(pipeFd) != 0) {
+        perror("pipe");
+        return 1;
+    }
+#ifdef F_SETPIPE_SZ
+    fcntl(pipeFd[1],F_SETPIPE_SZ,1 << 20);
+#endif
+    std::thread drain(RdlcBenchDrain,pipeFd[0]);
+
+    printf("RDLC TX cost per frame: WriteBytes+write vs WriteIovec+writev\n");
+    printf("%10s %14s %14s %14s %14s\n","payload","write(ns)","write(GB/s)","writev(ns)","writev(GB/s)");
+
+    for (uint16_t payloadSize : payloadSizes) {
+        RdlcConfig_t config = {
+            .msgMaxSize = payloadSize,
+            .msgMaxEscapeSize = (uint16_t)(payloadSize / 16),
+            .cbParsed = NULL,
+            .cbError = NULL,
+        };
+        RdlcPort_t port = {
+            .portMalloc = malloc,
+            .portFree = free,
+            .portPrintf = NULL
+        };
+        Rdlc_t handle = xRdlcCreate(&config,&port);
+        if (handle == NULL) {
+            printf("rdlc: init handle failed\n");
+            return 1;
+        }
+
+        std::vector<uint8_t> payload(payloadSize);
+        for (size_t i = 0; i < payload.size(); i++)
+            payload[i] = (uint8_t)rand();
+        RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+        int frames = (int)(bytesPerCase / payloadSize);
+
+        std::vector<uint8_t> frame(xRdlcGetFrameSize(handle,addr,payload.data(),payloadSize));
+        BenchClock_t::time_point start = BenchClock_t::now();
+        for (int f = 0; f < frames; f++) {
+            int len = xRdlcWriteBytes(handle,addr,payload.data(),payloadSize,frame.data(),frame.size());
+            if (len <= 0 || !RdlcBenchWriteAll(pipeFd[1],frame.data(),len)) {
+                printf("rdlc: write failed %d\n",len);
+                return 1;
+            }
+        }
+        double writeNs = std::chrono::duration<double,std::nano>(BenchClock_t::now() - start).count() / frames;
+
+        std::vector<RdlcFragment_t> fragments(payloadSize + 3);
+        std::vector<struct iovec> iov(payloadSize + 3);
+        uint8_t scratch[RDLC_IOV_SCRATCH_SIZE];
+        start = BenchClock_t::now();
+        for (int f = 0; f < frames; f++) {
+            int count = xRdlcWriteIovec(handle,addr,payload.data(),payloadSize,fragments.data(),fragments.size(),scratch,sizeof(scratch));
+            if (count <= 0) {
+                printf("rdlc: writev encode failed %d\n",count);
+                return 1;
+            }
+            for (int i = 0; i < count; i++) {
+                iov[i].iov_base = (void *)fragments[i].data;
+                iov[i].iov_len = fragments[i].size;
+            }
+            if (!RdlcBenchWritevAll(pipeFd[1],iov.data(),count)) {
+                printf("rdlc: writev failed\n");
+                return 1;
+            }
+        }
+        double writevNs = std::chrono::duration<double,std::nano>(BenchClock_t::now() - start).count() / frames;
+
+        printf("%10u %14.0f %14.2f %14.0f %14.2f\n",payloadSize,
+               writeNs,payloadSize / writeNs,writevNs,payloadSize / writevNs);
+        vRdlcDestroy(handle);
+    }
+
+    close(pipeFd[1]);
+    drain.join();
+    close(pipeFd[0]);
+    return 0;
+}
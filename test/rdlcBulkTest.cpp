@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief ص¼ÿλصĵַغɰ˳¼ʵ֮Ƚ
+**/
+struct RdlcRecord_t
+{
+    uint8_t srcAddr;
+    uint8_t dstAddr;
+    std::vector<uint8_t> payload;
+
+    bool operator==(const RdlcRecord_t &other) const {
+        return srcAddr == other.srcAddr && dstAddr == other.dstAddr && payload == other.payload;
+    }
+};
+
+static std::vector<RdlcRecord_t> BulkRefRecords;
+static std::vector<RdlcRecord_t> BulkDutRecords;
+
+extern "C" int RdlcBulkRefCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    BulkRefRecords.push_back({addr.srcAddr,addr.dstAddr,std::vector<uint8_t>(data,data+size)});
+    return 0;
+}
+
+extern "C" int RdlcBulkDutCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    BulkDutRecords.push_back({addr.srcAddr,addr.dstAddr,std::vector<uint8_t>(data,data+size)});
+    return 0;
+}
+
+/**
+ *@brief һδض֡תַֽ
+**/
+static std::vector<uint8_t> RdlcBulkMakeStream(Rdlc_t encoder,std::mt19937 &rng,int frames,uint16_t msgMaxSize,int escapePercent)
+{
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(msgMaxSize,msgMaxSize));
+    std::uniform_int_distribution<int> byteDist(0,255);
+    std::uniform_int_distribution<int> percentDist(0,99);
+    std::uniform_int_distribution<int> sizeDist(1,msgMaxSize);
+
+    for (int f = 0; f < frames; f++) {
+        // ֡
+        if (percentDist(rng) < 20) {
+            int noise = percentDist(rng) % 8;
+            for (int i = 0; i < noise; i++)
+                stream.push_back(byteDist(rng));
+        }
+
+        std::vector<uint8_t> payload(sizeDist(rng));
+        for (auto &b : payload)
+            b = (percentDist(rng) < escapePercent) ? 0xFF : byteDist(rng);
+        RdlcAddr_t addr = {.srcAddr = (uint8_t)byteDist(rng), .dstAddr = (uint8_t)byteDist(rng)};
+
+        int len = xRdlcWriteBytes(encoder,addr,payload.data(),payload.size(),frame.data(),frame.size());
+        EXPECT_GT(len,RDLC_OK) << "rdlc: write failed";
+        if (len <= 0)
+            continue;
+
+        // żضϻһ֡
+        int action = percentDist(rng);
+        if (action < 5)
+            len = percentDist(rng) % len;
+        else if (action < 10)
+            frame[percentDist(rng) % len] ^= (1 << (percentDist(rng) % 8));
+        stream.insert(stream.end(),frame.begin(),frame.begin()+len);
+    }
+    return stream;
+}
+
+/**
+ *@brief 1ֽڽְʽ½һ
+**/
+TEST(RdlcTestBulk, SpanEqualsByteWise)
+{
+    const uint16_t msgMaxSize = 300;
+    static const RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL
+    };
+    RdlcConfig_t refConfig = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = RdlcBulkRefCallback,
+        .cbError = NULL,
+    };
+    RdlcConfig_t dutConfig = refConfig;
+    dutConfig.cbParsed = RdlcBulkDutCallback;
+
+    std::mt19937 rng(20250516);
+    const int escapePercents[] = {0,1,10,50};
+    const uint16_t flagsList[] = {0,RDLC_FLAG_RX_ZERO_COPY};
+
+    for (uint16_t flags : flagsList)
+    for (int escapePercent : escapePercents) {
+        dutConfig.flags = flags;
+        Rdlc_t ref = xRdlcCreate(&refConfig,&port);
+        Rdlc_t dut = xRdlcCreate(&dutConfig,&port);
+        ASSERT_NE(ref,nullptr) << "rdlc: init handle failed";
+        ASSERT_NE(dut,nullptr) << "rdlc: init handle failed";
+        BulkRefRecords.clear();
+        BulkDutRecords.clear();
+
+        std::vector<uint8_t> stream = RdlcBulkMakeStream(ref,rng,200,msgMaxSize,escapePercent);
+        std::uniform_int_distribution<int> chunkDist(1,700);
+
+        size_t pos = 0;
+        while (pos < stream.size()) {
+            size_t chunk = std::min<size_t>(chunkDist(rng),stream.size()-pos);
+
+            // οʵֽ֣ȫֽڣصһûдʱһֽڵĽ
+            int refRes = RDLC_NOT_FINISH;
+            int refErr = RDLC_OK;
+            for (size_t i = 0; i < chunk; i++) {
+                refRes = xRdlcReadByte(ref,stream[pos+i]);
+                if (refRes != RDLC_OK && refRes != RDLC_NOT_FINISH && refErr == RDLC_OK)
+                    refErr = refRes;
+            }
+            if (refErr != RDLC_OK)
+                refRes = refErr;
+            int dutRes = xRdlcReadBytes(dut,&stream[pos],chunk);
+
+            ASSERT_EQ(refRes,dutRes) << "rdlc: result mismatch at offset " << pos;
+            ASSERT_EQ(xRdlcGetParseState(ref),xRdlcGetParseState(dut)) << "rdlc: parse state mismatch at offset " << pos;
+            ASSERT_EQ(xRdlcGetEscapeState(ref),xRdlcGetEscapeState(dut)) << "rdlc: escape state mismatch at offset " << pos;
+            pos += chunk;
+        }
+
+        EXPECT_GT(BulkRefRecords.size(),0u) << "rdlc: no frame parsed";
+        EXPECT_TRUE(BulkRefRecords == BulkDutRecords) << "rdlc: parsed frames mismatch, escape=" << escapePercent << "%, flags=" << flags;
+
+        vRdlcDestroy(ref);
+        vRdlcDestroy(dut);
+    }
+}
+
+/**
+ *@brief 2һֽ֡ڴгΣܱȷ
+**/
+TEST(RdlcTestBulk, SplitAtAnyByte)
+{
+    const uint8_t expected[] = {0x1,0xFF,0xC0,0x0C,0xFF,0xFF,0x7,0x8,0x9,0xA,0xB,0xFF};
+    const RdlcAddr_t expectAddr = {.srcAddr = 0xFF, .dstAddr = 0x0C};
+
+    static const RdlcConfig_t config = {
+        .msgMaxSize = sizeof(expected),
+        .msgMaxEscapeSize = sizeof(expected),
+        .cbParsed = RdlcBulkDutCallback,
+        .cbError = NULL,
+    };
+    static const RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL
+    };
+    Rdlc_t handle = xRdlcCreate(&config, &port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    uint8_t txBuf[64];
+    int len = xRdlcWriteBytes(handle,expectAddr,expected,sizeof(expected),txBuf,sizeof(txBuf));
+    ASSERT_GT(len,RDLC_OK) << "rdlc: write failed";
+
+    for (int cut = 0; cut <= len; cut++) {
+        BulkDutRecords.clear();
+        int err1 = xRdlcReadBytes(handle,txBuf,cut);
+        int err2 = xRdlcReadBytes(handle,&txBuf[cut],len-cut);
+        EXPECT_EQ((cut == len) ? err1 : err2,RDLC_OK) << "rdlc: read not finish, cut=" << cut;
+        ASSERT_EQ(BulkDutRecords.size(),1u) << "rdlc: frame lost, cut=" << cut;
+        EXPECT_EQ(BulkDutRecords[0].srcAddr,expectAddr.srcAddr);
+        EXPECT_EQ(BulkDutRecords[0].dstAddr,expectAddr.dstAddr);
+        EXPECT_EQ(BulkDutRecords[0].payload,std::vector<uint8_t>(expected,expected+sizeof(expected)));
+    }
+
+    vRdlcDestroy(handle);
+}
+
+/**
+ *@brief 3תַSIMDλáغʱغɶܱȷ
+**/
+TEST(RdlcTestBulk, EscapeAtAnyOffset)
+{
+    const uint16_t payloadSize = 200;
+    static const RdlcConfig_t config = {
+        .msgMaxSize = payloadSize,
+        .msgMaxEscapeSize = 2,
+        .cbParsed = RdlcBulkDutCallback,
+        .cbError = NULL,
+    };
+    static const RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL
+    };
+    Rdlc_t handle = xRdlcCreate(&config, &port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::vector<uint8_t> payload(payloadSize);
+    std::vector<uint8_t> txBuf(RDLC_GET_FRAME_SIZE(payloadSize,2) + 64);
+    const RdlcAddr_t expectAddr = {.srcAddr = 0x01, .dstAddr = 0x02};
+
+    for (int offset = 0; offset < payloadSize; offset++) {
+        for (int i = 0; i < payloadSize; i++)
+            payload[i] = (uint8_t)(i * 7 + 1) == 0xFF ? 0x00 : (uint8_t)(i * 7 + 1);
+        payload[offset] = 0xFF;
+        payload[payloadSize - 1 - offset] = 0xFF;
+
+        // ֡ڻеʼλãǲͬڴ
+        size_t align = offset % 32;
+        int len = xRdlcWriteBytes(handle,expectAddr,payload.data(),payloadSize,&txBuf[align],txBuf.size()-align);
+        ASSERT_GT(len,RDLC_OK) << "rdlc: write failed";
+
+        BulkDutRecords.clear();
+        int err = xRdlcReadBytes(handle,&txBuf[align],len);
+        ASSERT_EQ(err,RDLC_OK) << "rdlc: read not finish, offset=" << offset;
+        ASSERT_EQ(BulkDutRecords.size(),1u) << "rdlc: frame lost, offset=" << offset;
+        EXPECT_EQ(BulkDutRecords[0].payload,payload) << "rdlc: payload mismatch, offset=" << offset;
+    }
+
+    vRdlcDestroy(handle);
+}
+
+/**
+ *@brief 4㿽գҲתֱ֡뻺˻ؽջ
+**/
+static const uint8_t *ZeroCopyPayload = NULL;
+
+extern "C" int RdlcZeroCopyCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    ZeroCopyPayload = data;
+    return RdlcBulkDutCallback(handle,addr,data,size);
+}
+
+TEST(RdlcTestBulk, ZeroCopy)
+{
+    const uint8_t plain[]   = {0x1,0x2,0x3,0x4,0x5,0x6,0x7,0x8};
+    const uint8_t escaped[] = {0x1,0x2,0xFF,0x4,0x5,0x6,0x7,0x8};
+    const RdlcAddr_t expectAddr = {.srcAddr = 0x01, .dstAddr = 0x02};
+
+    static const RdlcConfig_t config = {
+        .msgMaxSize = sizeof(plain),
+        .msgMaxEscapeSize = 2,
+        .cbParsed = RdlcZeroCopyCallback,
+        .cbError = NULL,
+        .flags = RDLC_FLAG_RX_ZERO_COPY,
+    };
+    static const RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL
+    };
+    Rdlc_t handle = xRdlcCreate(&config, &port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    uint8_t txBuf[64];
+    int len = xRdlcWriteBytes(handle,expectAddr,plain,sizeof(plain),txBuf,sizeof(txBuf));
+    ASSERT_GT(len,RDLC_OK) << "rdlc: write failed";
+
+    // ֡һУغָָ뻺
+    BulkDutRecords.clear();
+    ASSERT_EQ(xRdlcReadBytes(handle,txBuf,len),RDLC_OK) << "rdlc: read not finish";
+    ASSERT_EQ(BulkDutRecords.size(),1u) << "rdlc: frame lost";
+    EXPECT_EQ(BulkDutRecords[0].payload,std::vector<uint8_t>(plain,plain+sizeof(plain)));
+    EXPECT_TRUE(ZeroCopyPayload >= txBuf && ZeroCopyPayload < txBuf + len) << "rdlc: payload was copied";
+
+    // 룺˻ؽջ
+    BulkDutRecords.clear();
+    ASSERT_EQ(xRdlcReadBytes(handle,txBuf,len/2),RDLC_NOT_FINISH);
+    ASSERT_EQ(xRdlcReadBytes(handle,&txBuf[len/2],len-len/2),RDLC_OK) << "rdlc: read not finish";
+    ASSERT_EQ(BulkDutRecords.size(),1u) << "rdlc: frame lost";
+    EXPECT_EQ(BulkDutRecords[0].payload,std::vector<uint8_t>(plain,plain+sizeof(plain)));
+    EXPECT_FALSE(ZeroCopyPayload >= txBuf && ZeroCopyPayload < txBuf + sizeof(txBuf)) << "rdlc: split frame not copied";
+
+    // תַ˻ؽջ
+    len = xRdlcWriteBytes(handle,expectAddr,escaped,sizeof(escaped),txBuf,sizeof(txBuf));
+    ASSERT_GT(len,RDLC_OK) << "rdlc: write failed";
+    BulkDutRecords.clear();
+    ASSERT_EQ(xRdlcReadBytes(handle,txBuf,len),RDLC_OK) << "rdlc: read not finish";
+    ASSERT_EQ(BulkDutRecords.size(),1u) << "rdlc: frame lost";
+    EXPECT_EQ(BulkDutRecords[0].payload,std::vector<uint8_t>(escaped,escaped+sizeof(escaped)));
+    EXPECT_FALSE(ZeroCopyPayload >= txBuf && ZeroCopyPayload < txBuf + sizeof(txBuf)) << "rdlc: escaped frame not copied";
+
+    // CRC볣һ
+    len = xRdlcWriteBytes(handle,expectAddr,plain,sizeof(plain),txBuf,sizeof(txBuf));
+    txBuf[len-4] ^= 0x01;
+    BulkDutRecords.clear();
+    EXPECT_EQ(xRdlcReadBytes(handle,txBuf,len),RDLC_ERR_CRC) << "rdlc: crc error not reported";
+    EXPECT_EQ(BulkDutRecords.size(),0u) << "rdlc: corrupted frame delivered";
+
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 5֡65535ֽڵغ0xFF 0xC1ͷһְȷ
+ *       δÿȵʵܴغãҲԿ֡
+**/
+extern "C" int RdlcBulkWideCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,size_t size)
+{
+    BulkDutRecords.push_back({addr.srcAddr,addr.dstAddr,std::vector<uint8_t>(data,data+size)});
+    return 0;
+}
+
+TEST(RdlcTestBulk, WideLength)
+{
+    const uint32_t msgMaxSize = 300000;
+    const size_t payloadSizes[] = {100,0xFFFF,0x10000,0x1FFFF,250000};
+    static const RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL
+    };
+
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = RdlcBulkRefCallback,
+        .cbError = NULL,
+        .flags = 0,
+    };
+    EXPECT_EQ(xRdlcCreate(&config,&port),nullptr) << "rdlc: large msgMaxSize without RDLC_FLAG_WIDE_LENGTH";
+
+    config.flags = RDLC_FLAG_WIDE_LENGTH;
+    config.cbParsedWide = RdlcBulkWideCallback;
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+    config.flags = RDLC_FLAG_WIDE_LENGTH | RDLC_FLAG_RX_ZERO_COPY;
+    Rdlc_t zeroCopy = xRdlcCreate(&config,&port);
+    ASSERT_NE(zeroCopy, nullptr) << "rdlc: init handle failed";
+    config.msgMaxSize = 0xFFFF;
+    config.msgMaxEscapeSize = 0xFFFF;
+    config.flags = 0;
+    config.cbParsedWide = NULL;
+    Rdlc_t narrow = xRdlcCreate(&config,&port);
+    ASSERT_NE(narrow, nullptr) << "rdlc: init handle failed";
+
+    std::mt19937 rng(0x0C1C);
+    std::vector<uint8_t> stream;
+    std::vector<RdlcRecord_t> expected;
+    std::vector<RdlcRecord_t> expectedNarrow;
+    for (size_t payloadSize : payloadSizes) {
+        std::vector<uint8_t> payload(payloadSize);
+        for (auto &b : payload)
+            b = (rng() % 100 < 2) ? 0xFF : (rng() % 255);
+        payload[0] = (payloadSize & 1) ? 0x00 : 0xFF;// һ֡ת壬㿽
+        if (payloadSize == 100)
+            std::fill(payload.begin(),payload.end(),0x5A);
+        RdlcAddr_t addr = {.srcAddr = (uint8_t)rng(), .dstAddr = 0xFF};
+
+        int frameSize = xRdlcGetFrameSize(handle,addr,payload.data(),payload.size());
+        ASSERT_GT(frameSize,RDLC_OK);
+        std::vector<uint8_t> frame(frameSize);
+        ASSERT_EQ(xRdlcWriteBytes(handle,addr,payload.data(),payload.size(),frame.data(),frame.size()),frameSize);
+        EXPECT_EQ(frame[1],(payloadSize > 0xFFFF) ? 0xC1 : 0xC0) << "rdlc: head, size=" << payloadSize;
+
+        stream.push_back(0x33);
+        stream.insert(stream.end(),frame.begin(),frame.end());
+        expected.push_back({addr.srcAddr,addr.dstAddr,payload});
+        if (payloadSize <= 0xFFFF)
+            expectedNarrow.push_back({addr.srcAddr,addr.dstAddr,payload});
+    }
+    ASSERT_GT(stream.size(),0x10000u);
+
+    // һֽ
+    BulkDutRecords.clear();
+    EXPECT_EQ(xRdlcReadBytes(handle,stream.data(),stream.size()),RDLC_OK);
+    EXPECT_EQ(BulkDutRecords,expected);
+
+    // ְ㿽
+    BulkDutRecords.clear();
+    for (size_t pos = 0; pos < stream.size(); ) {
+        size_t chunk = std::min<size_t>(stream.size() - pos,1 + rng() % 100000);
+        xRdlcReadBytes(zeroCopy,&stream[pos],chunk);
+        pos += chunk;
+    }
+    EXPECT_EQ(BulkDutRecords,expected);
+
+    // δÿȣֻյͨ֡
+    BulkRefRecords.clear();
+    xRdlcReadBytes(narrow,stream.data(),stream.size());
+    EXPECT_EQ(BulkRefRecords,expectedNarrow);
+
+    vRdlcDestroy(handle);
+    vRdlcDestroy(zeroCopy);
+    vRdlcDestroy(narrow);
+}
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief οʵ֣λCRC-16/MODBUS
+**/
+static uint16_t RdlcCrcReference(uint16_t crc,const uint8_t *data,size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; ++j)
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ 0xA001) : (crc >> 1);
+    }
+    return crc;
+}
+
+//========================================================================================
+
+/**
+ *@brief 1ǰCRCⳤȡ¶οʵһ
+**/
+TEST(RdlcTestCrc, EngineMatchesReference)
+{
+    std::mt19937 rng(0xA001);
+    std::vector<uint8_t> data(4096 + 64);
+    for (auto &b : data)
+        b = rng();
+
+    // ׼Уֵ
+    const uint8_t check[] = {'1','2','3','4','5','6','7','8','9'};
+    EXPECT_EQ(xRdlcCrc16Update(NULL,RDLC_CRC16_INIT_VALUE,check,sizeof(check)),0x4B37) << "rdlc: crc check value";
+
+    for (size_t len = 0; len <= 1024; len++) {
+        size_t align = len % 16;
+        uint16_t expected = RdlcCrcReference(RDLC_CRC16_INIT_VALUE,&data[align],len);
+        ASSERT_EQ(xRdlcCrc16Update(NULL,RDLC_CRC16_INIT_VALUE,&data[align],len),expected) << "rdlc: crc mismatch, len=" << len;
+    }
+
+    // ֶۼ
+    for (int round = 0; round < 200; round++) {
+        size_t len = rng() % 4096;
+        size_t cut = len ? rng() % len : 0;
+        uint16_t crc = xRdlcCrc16Update(NULL,RDLC_CRC16_INIT_VALUE,&data[1],cut);
+        crc = xRdlcCrc16Update(NULL,crc,&data[1 + cut],len - cut);
+        ASSERT_EQ(crc,RdlcCrcReference(RDLC_CRC16_INIT_VALUE,&data[1],len)) << "rdlc: chained crc mismatch, len=" << len;
+    }
+}
+
+//========================================================================================
+
+/**
+ *@brief 2ӲCRCӿڣͽͨportCrc16
+**/
+static int CrcHookCalls = 0;
+
+extern "C" uint16_t RdlcTestCrcHook(uint16_t crc,const uint8_t *data,size_t length)
+{
+    CrcHookCalls++;
+    return RdlcCrcReference(crc,data,length);
+}
+
+extern "C" {
+    static ::testing::StrictMock<RdlcMockCallback_t> CrcHookMock;
+}
+
+extern "C" int RdlcTestCrcHookCallback(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    CrcHookMock.OnParsed(handle,addr,data,size);
+    return 0;
+}
+
+TEST(RdlcTestCrc, HardwareHook)
+{
+    const uint8_t expected[] = {0x1,0xFF,0x3,0x4,0x5,0x6,0x7,0x8,0x9,0xA,0xB,0xC,0xD};
+    const RdlcAddr_t expectAddr = {.srcAddr = 0x01, .dstAddr = 0x02};
+
+    static const RdlcConfig_t config = {
+        .msgMaxSize = sizeof(expected),
+        .msgMaxEscapeSize = 3,
+        .cbParsed = RdlcTestCrcHookCallback,
+        .cbError = NULL,
+    };
+    static const RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+        .portCrc16 = RdlcTestCrcHook,
+    };
+    static RdlcStaticHandle_t staticHandle;
+    static uint8_t staticRxBuffer[64];
+    Rdlc_t handle = xRdlcCreateStatic(&config,&port,&staticHandle,staticRxBuffer,sizeof(staticRxBuffer));
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    uint8_t txBuf[40];
+    CrcHookCalls = 0;
+    int len = xRdlcWriteBytes(handle,expectAddr,expected,sizeof(expected),txBuf,sizeof(txBuf));
+    ASSERT_GT(len,RDLC_OK) << "rdlc: write failed";
+    EXPECT_GT(CrcHookCalls,0) << "rdlc: hook not used when writing";
+
+    CrcHookCalls = 0;
+    EXPECT_CALL(CrcHookMock, OnParsed(::testing::_,AddrEq(expectAddr.srcAddr,expectAddr.dstAddr),EqWithMessage(expected,sizeof(expected)),sizeof(expected)));
+    ASSERT_EQ(xRdlcReadBytes(handle,txBuf,len),RDLC_OK) << "rdlc: read not finish";
+    EXPECT_GT(CrcHookCalls,0) << "rdlc: hook not used when reading";
+    EXPECT_EQ(xRdlcCrc16Update(handle,RDLC_CRC16_INIT_VALUE,expected,sizeof(expected)),
+              RdlcCrcReference(RDLC_CRC16_INIT_VALUE,expected,sizeof(expected)));
+}
+
+//========================================================================================
+
+/**
+ *@brief 3۵ں(CPU֧)ⳤȡ롢ֵοʵһ
+**/
+TEST(RdlcTestCrc, FoldMatchesReference)
+{
+    std::mt19937 rng(0x8005);
+    std::vector<uint8_t> data(2048 + 16);
+    for (auto &b : data)
+        b = rng();
+
+    for (size_t align = 0; align < 16; align++) {
+        uint16_t init = rng();
+        uint16_t expected = init;
+        for (size_t len = 0; len <= 2048; len++) {
+            ASSERT_EQ(xRdlcCrc16Update(NULL,init,&data[align],len),expected) << "rdlc: crc mismatch, len=" << len << ",align=" << align;
+            if (len < 2048)
+                expected = RdlcCrcReference(expected,&data[align + len],1);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief ַԣÿ߼˿(Ŀĵַ)ԼĻصģҪcbParsedswitch
+**/
+struct DispatchPort_t
+{
+    int id;
+    std::vector<std::vector<uint8_t>> records;
+    std::vector<RdlcAddr_t> addrs;
+};
+
+extern "C" int RdlcDispatchOnPort(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,size_t size,void *ctx)
+{
+    DispatchPort_t *port = (DispatchPort_t*)ctx;
+    port->records.push_back(std::vector<uint8_t>(data,data+size));
+    port->addrs.push_back(addr);
+    return 0;
+}
+
+static Rdlc_t RdlcDispatchCreate(RdlcDispatch_t *dispatch)
+{
+    RdlcConfig_t config = RdlcTestConfig(64);
+    config.dispatch = dispatch;
+    return RdlcTestCreate(config);
+}
+
+static void RdlcDispatchSend(Rdlc_t handle,uint8_t srcAddr,uint8_t dstAddr,uint8_t tag)
+{
+    RdlcAddr_t addr = {.srcAddr = srcAddr, .dstAddr = dstAddr};
+    std::vector<uint8_t> frame = RdlcTestEncode(handle,{srcAddr,dstAddr,tag},addr);
+    EXPECT_EQ(xRdlcReadBytes(handle,frame.data(),frame.size()),RDLC_OK);
+}
+
+TEST(RdlcTestDispatch, Ports)
+{
+    static RdlcDispatch_t dispatch;
+    DispatchPort_t fallback = {-1};
+    std::vector<DispatchPort_t> ports(48);
+    EXPECT_EQ(xRdlcDispatchInit(NULL,NULL,NULL),RDLC_ERR_INVALID_ARG);
+    ASSERT_EQ(xRdlcDispatchInit(&dispatch,RdlcDispatchOnPort,&fallback),RDLC_OK);
+    for (int i = 0; i < (int)ports.size(); i++) {
+        ports[i].id = i;
+        // ˿0ֻ0x10֡಻Դַ
+        int srcAddr = (i == 0) ? 0x10 : RDLC_ADDR_ANY;
+        ASSERT_EQ(xRdlcDispatchRegister(&dispatch,srcAddr,(uint8_t)(0x80 + i),RdlcDispatchOnPort,&ports[i]),RDLC_OK);
+    }
+    EXPECT_EQ(xRdlcDispatchRegister(&dispatch,0x100,0x01,RdlcDispatchOnPort,NULL),RDLC_ERR_INVALID_ARG);
+
+    Rdlc_t handle = RdlcDispatchCreate(&dispatch);
+    ASSERT_NE(handle,nullptr);
+    RdlcTestRecords.clear();
+
+    for (int i = 0; i < (int)ports.size(); i++)
+        RdlcDispatchSend(handle,0x10,(uint8_t)(0x80 + i),(uint8_t)i);
+    for (int i = 0; i < (int)ports.size(); i++) {
+        ASSERT_EQ(ports[i].records.size(),1u) << "rdlc: port " << i;
+        EXPECT_EQ(ports[i].records[0],std::vector<uint8_t>({0x10,(uint8_t)(0x80 + i),(uint8_t)i}));
+        EXPECT_EQ(ports[i].addrs[0].srcAddr,0x10);
+    }
+
+    // δעĿĵַԴַ֡fallback
+    RdlcDispatchSend(handle,0x10,0x05,0xAA);
+    RdlcDispatchSend(handle,0x11,0x80,0xBB);
+    ASSERT_EQ(fallback.records.size(),2u);
+    EXPECT_EQ(fallback.records[0][2],0xAA);
+    EXPECT_EQ(fallback.records[1][2],0xBB);
+    EXPECT_EQ(ports[0].records.size(),1u);
+
+    // ע󽻸fallbackûfallbackʱ
+    ASSERT_EQ(xRdlcDispatchRegister(&dispatch,RDLC_ADDR_ANY,0x81,NULL,NULL),RDLC_OK);
+    RdlcDispatchSend(handle,0x10,0x81,0xCC);
+    EXPECT_EQ(ports[1].records.size(),1u);
+    ASSERT_EQ(fallback.records.size(),3u);
+    ASSERT_EQ(xRdlcDispatchInit(&dispatch,NULL,NULL),RDLC_OK);
+    RdlcDispatchSend(handle,0x10,0x82,0xDD);
+    EXPECT_EQ(ports[2].records.size(),1u);
+    EXPECT_EQ(fallback.records.size(),3u);
+
+    EXPECT_TRUE(RdlcTestRecords.empty()) << "rdlc: cbParsed must not run when a dispatch table is set";
+    vRdlcDestroy(handle);
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief ѭDMAղԣģѭģʽDMAͰȫж
+**/
+
+TEST(RdlcTestDma, Wrap)
+{
+    Rdlc_t handle = RdlcTestCreate(64);
+    ASSERT_NE(handle,nullptr);
+    uint8_t dmaBuf[32];
+    RdlcDmaRx_t dma;
+    EXPECT_EQ(xRdlcDmaRxInit(handle,&dma,dmaBuf,0),RDLC_ERR_INVALID_ARG);
+    ASSERT_EQ(xRdlcDmaRxInit(handle,&dma,dmaBuf,sizeof(dmaBuf)),RDLC_OK);
+    EXPECT_EQ(xRdlcDmaRxUpdate(&dma,sizeof(dmaBuf) + 1),RDLC_ERR_INVALID_ARG);
+
+    std::vector<uint8_t> payload = {0x11,0xFF,0x22,0x33,0xFF,0xFF,0x44,0x55,0x66,0x77,0x88,0x99};
+    std::vector<uint8_t> frame = RdlcTestEncode(handle,payload);
+    int len = frame.size();
+
+    // ǰ20ֽ֡20ʼд벢ĩβ
+    memset(dmaBuf,0x5A,sizeof(dmaBuf));
+    EXPECT_EQ(xRdlcDmaRxUpdate(&dma,20),RDLC_NOT_FINISH);
+    RdlcTestRecords.clear();
+    for (int i = 0; i < len; i++)
+        dmaBuf[(20 + i) % sizeof(dmaBuf)] = frame[i];
+    uint32_t writeIndex = (20 + len) % sizeof(dmaBuf);
+    EXPECT_EQ(xRdlcDmaRxUpdate(&dma,writeIndex),RDLC_OK);
+    ASSERT_EQ(RdlcTestRecords.size(),1u);
+    EXPECT_EQ(RdlcTestRecords[0],payload);
+    EXPECT_EQ(xRdlcDmaRxUpdate(&dma,writeIndex),RDLC_NOT_FINISH);
+    vRdlcDestroy(handle);
+}
+
+/**
+ *@brief һģ⣺ʱֽΪλ·æʱDMAÿʱдһֽڣ
+ *       дһ롢дĩβ·תΪʱжϣжӳٺִУִʱDMAѾдֽ
+**/
+static void RdlcDmaSimulate(uint32_t seed,uint32_t dmaSize,uint16_t flags)
+{
+    const uint16_t msgMaxSize = 200;
+    Rdlc_t txHandle = RdlcTestCreate(msgMaxSize,flags);
+    Rdlc_t rxHandle = RdlcTestCreate(msgMaxSize,flags);
+    ASSERT_NE(txHandle,nullptr);
+    ASSERT_NE(rxHandle,nullptr);
+    std::mt19937 rng(seed);
+
+    // ֮֡ʱ䣬֡żжݵļ϶
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<int> line;
+    for (int i = 0; i < 300; i++) {
+        std::vector<uint8_t> payload(1 + rng() % msgMaxSize);
+        for (auto &b : payload)
+            b = (rng() % 8 == 0) ? 0xFF : (uint8_t)rng();
+        for (uint8_t byte : RdlcTestEncode(txHandle,payload)) {
+            line.push_back(byte);
+            if (rng() % 64 == 0)
+                line.insert(line.end(),1 + rng() % 3,-1);
+        }
+        line.insert(line.end(),rng() % 40,-1);
+        payloads.push_back(payload);
+    }
+    line.insert(line.end(),4,-1);
+
+    std::vector<uint8_t> dmaBuf(dmaSize);
+    RdlcDmaRx_t dma;
+    ASSERT_EQ(xRdlcDmaRxInit(rxHandle,&dma,dmaBuf.data(),dmaSize),RDLC_OK);
+    RdlcTestRecords.clear();
+
+    // жӳСڰ֤жִǰDMA׷δ
+    const uint32_t maxLatency = dmaSize / 2 - 1;
+    uint32_t writeIndex = 0;
+    bool busy = false;
+    int64_t irqAt = -1;
+    for (int64_t t = 0; t < (int64_t)line.size() || irqAt >= 0; t++) {
+        bool hasByte = t < (int64_t)line.size() && line[t] >= 0;
+        bool raise = false;
+        if (hasByte) {
+            dmaBuf[writeIndex] = (uint8_t)line[t];
+            writeIndex = (writeIndex + 1) % dmaSize;
+            raise = (writeIndex == dmaSize / 2) || (writeIndex == 0);
+        }
+        else if (busy)
+            raise = true; // ж
+        busy = hasByte;
+        if (raise && irqAt < 0)
+            irqAt = t + rng() % (maxLatency + 1);
+        if (irqAt >= 0 && t >= irqAt) {
+            irqAt = -1;
+            // дλ0ʱеļֵ
+            uint32_t index = (writeIndex == 0 && (rng() & 1)) ? dmaSize : writeIndex;
+            int res = xRdlcDmaRxUpdate(&dma,index);
+            EXPECT_THAT(res,::testing::AnyOf(RDLC_OK,RDLC_NOT_FINISH)) << "rdlc: seed " << seed;
+        }
+    }
+    EXPECT_EQ(RdlcTestRecords,payloads) << "rdlc: seed " << seed << " dma size " << dmaSize << " flags " << flags;
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rxHandle);
+}
+
+TEST(RdlcTestDma, RandomInterruptTiming)
+{
+    const uint32_t dmaSizes[] = {16,64,250,1024};
+    for (uint16_t flags : {(uint16_t)0,(uint16_t)RDLC_FLAG_RX_ZERO_COPY})
+        for (uint32_t dmaSize : dmaSizes)
+            for (uint32_t seed = 0; seed < 8; seed++)
+                RdlcDmaSimulate(seed,dmaSize,flags);
+}
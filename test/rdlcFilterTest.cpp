@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief Ŀĵַ˲ԣϻзڵֻ֡ͨ˵֡ص
+**/
+
+static Rdlc_t RdlcFilterCreate(const RdlcAddrFilter_t *filter,uint16_t flags)
+{
+    RdlcConfig_t config = RdlcTestConfig(128,flags);
+    config.addrFilter = filter;
+    return RdlcTestCreate(config);
+}
+
+/**
+ *@brief һݣÿ֡Ŀĵַ015֮ӦյغɺĿĵַ
+**/
+static std::vector<uint8_t> RdlcFilterBus(Rdlc_t txHandle,uint32_t seed,bool (*accept)(uint8_t),
+                                         std::vector<std::vector<uint8_t>> &expected,std::vector<uint8_t> &expectedDst)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> bus;
+    for (int i = 0; i < 400; i++) {
+        RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = (uint8_t)(rng() % 16)};
+        std::vector<uint8_t> payload(1 + rng() % 128);
+        for (auto &b : payload)
+            b = (rng() % 6 == 0) ? 0xFF : (uint8_t)rng();
+        // غмд֡ͷ֡βֽ
+        if (payload.size() > 4 && rng() % 3 == 0) {
+            payload[1] = 0xFF;
+            payload[2] = (rng() & 1) ? 0xC0 : 0x0C;
+        }
+        std::vector<uint8_t> frame = RdlcTestEncode(txHandle,payload,addr);
+        if (accept(addr.dstAddr)) {
+            expected.push_back(payload);
+            expectedDst.push_back(addr.dstAddr);
+        }
+        bus.insert(bus.end(),frame.begin(),frame.end());
+    }
+    return bus;
+}
+
+static bool RdlcFilterIsNode5(uint8_t addr) { return addr == 5; }
+static bool RdlcFilterIsGroup(uint8_t addr) { return (addr & 0x0C) == 0x04; }
+static bool RdlcFilterIsOdd(uint8_t addr) { return addr & 1; }
+
+TEST(RdlcTestFilter, Modes)
+{
+    RdlcAddrFilter_t exact = {RDLC_ADDR_FILTER_EXACT,5,0,{0}};
+    RdlcAddrFilter_t mask = {RDLC_ADDR_FILTER_MASK,0x04,0x0C,{0}};
+    RdlcAddrFilter_t bitmap = {RDLC_ADDR_FILTER_BITMAP,0,0,{0}};
+    for (int addr = 1; addr < 256; addr += 2)
+        bitmap.bitmap[addr / 32] |= 1u << (addr % 32);
+    const RdlcAddrFilter_t *filters[] = {&exact,&mask,&bitmap};
+    bool (*accepts[])(uint8_t) = {RdlcFilterIsNode5,RdlcFilterIsGroup,RdlcFilterIsOdd};
+
+    Rdlc_t txHandle = RdlcFilterCreate(NULL,0);
+    ASSERT_NE(txHandle,nullptr);
+    for (int f = 0; f < 3; f++) {
+        for (uint16_t flags : {(uint16_t)0,(uint16_t)RDLC_FLAG_RX_ZERO_COPY}) {
+            std::vector<std::vector<uint8_t>> expected;
+            std::vector<uint8_t> expectedDst;
+            std::vector<uint8_t> bus = RdlcFilterBus(txHandle,f * 10 + flags,accepts[f],expected,expectedDst);
+            ASSERT_FALSE(expected.empty());
+
+            // 
+            Rdlc_t rxHandle = RdlcFilterCreate(filters[f],flags);
+            ASSERT_NE(rxHandle,nullptr);
+            RdlcTestRecords.clear();
+            RdlcTestDstAddrs.clear();
+            xRdlcReadBytes(rxHandle,bus.data(),bus.size());
+            EXPECT_EQ(RdlcTestRecords,expected) << "rdlc: filter " << f << " flags " << flags;
+            EXPECT_EQ(RdlcTestDstAddrs,expectedDst) << "rdlc: filter " << f << " flags " << flags;
+
+            // ֽ
+            RdlcTestRecords.clear();
+            RdlcTestDstAddrs.clear();
+            for (uint8_t byte : bus)
+                xRdlcReadByte(rxHandle,byte);
+            EXPECT_EQ(RdlcTestRecords,expected) << "rdlc: filter " << f << " byte by byte";
+            EXPECT_EQ(RdlcTestDstAddrs,expectedDst) << "rdlc: filter " << f << " byte by byte";
+            vRdlcDestroy(rxHandle);
+        }
+    }
+    vRdlcDestroy(txHandle);
+}
+
+TEST(RdlcTestFilter, SetAtRuntime)
+{
+    Rdlc_t handle = RdlcFilterCreate(NULL,0);
+    ASSERT_NE(handle,nullptr);
+    RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x22};
+    std::vector<uint8_t> frame = RdlcTestEncode(handle,{1,2,3,4},addr);
+
+    RdlcTestRecords.clear();
+    EXPECT_EQ(xRdlcReadBytes(handle,frame.data(),frame.size()),RDLC_OK);
+    RdlcAddrFilter_t filter = {RDLC_ADDR_FILTER_EXACT,0x21,0,{0}};
+    ASSERT_EQ(xRdlcSetAddrFilter(handle,&filter),RDLC_OK);
+    EXPECT_EQ(xRdlcReadBytes(handle,frame.data(),frame.size()),RDLC_NOT_FINISH);
+    EXPECT_EQ(xRdlcGetParseState(handle),RDLC_STATE_PARSE_WAIT_HEAD);
+    ASSERT_EQ(xRdlcSetAddrFilter(handle,NULL),RDLC_OK);
+    EXPECT_EQ(xRdlcReadBytes(handle,frame.data(),frame.size()),RDLC_OK);
+    EXPECT_EQ(RdlcTestRecords.size(),2u);
+
+    filter.mode = 9;
+    EXPECT_EQ(xRdlcSetAddrFilter(handle,&filter),RDLC_ERR_INVALID_ARG);
+    vRdlcDestroy(handle);
+}
+
+TEST(RdlcTestFilter, SplitRx)
+{
+    // ֶνյжϲĿĵַֹͣ棬ռò
+    RdlcAddrFilter_t exact = {RDLC_ADDR_FILTER_EXACT,5,0,{0}};
+    Rdlc_t txHandle = RdlcFilterCreate(NULL,0);
+    Rdlc_t rxHandle = RdlcFilterCreate(&exact,0);
+    std::vector<std::vector<uint8_t>> expected;
+    std::vector<uint8_t> expectedDst;
+    std::vector<uint8_t> bus = RdlcFilterBus(txHandle,7,RdlcFilterIsNode5,expected,expectedDst);
+
+    static uint8_t slots[64][RDLC_SPLIT_SLOT_SIZE(128)];
+    RdlcSplitRxConfig_t config = {&slots[0][0],sizeof(slots[0]),64};
+    RdlcSplitRx_t split;
+    ASSERT_EQ(xRdlcSplitRxInit(rxHandle,&split,&config),RDLC_OK);
+    RdlcTestRecords.clear();
+    RdlcTestDstAddrs.clear();
+    xRdlcSplitRxIsrBytes(&split,bus.data(),bus.size());
+    EXPECT_EQ(split.head,(uint32_t)expected.size());
+    EXPECT_EQ(xRdlcSplitRxPoll(&split),RDLC_OK);
+    EXPECT_EQ(RdlcTestRecords,expected);
+    EXPECT_EQ(RdlcTestDstAddrs,expectedDst);
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rxHandle);
+}
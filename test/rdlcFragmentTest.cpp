@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief Ƭԣͷ÷Ƭ֡շcbParsedаغɽ
+**/
+static RdlcReassembly_t FragmentReassembly;
+static uint32_t FragmentTick;
+static int FragmentLastResult;
+static std::vector<std::vector<uint8_t>> FragmentMessages;
+
+extern "C" int RdlcFragmentOnMessage(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,size_t size)
+{
+    FragmentMessages.push_back(std::vector<uint8_t>(data,data+size));
+    return 0;
+}
+
+extern "C" int RdlcFragmentOnParsed(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    FragmentLastResult = xRdlcReassemblyFeed(&FragmentReassembly,addr,data,size,FragmentTick);
+    return 0;
+}
+
+static Rdlc_t RdlcFragmentCreate(uint16_t msgMaxSize)
+{
+    RdlcConfig_t config = RdlcTestConfig(msgMaxSize);
+    config.cbParsed = RdlcFragmentOnParsed;
+    return RdlcTestCreate(config);
+}
+
+/**
+ *@brief һϢ֡ÿһ֡
+**/
+static std::vector<std::vector<uint8_t>> RdlcFragmentSplit(Rdlc_t handle,RdlcAddr_t addr,uint8_t msgId,const std::vector<uint8_t> &message)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    RdlcFragmenter_t fragmenter;
+    int count = xRdlcFragmenterInit(handle,&fragmenter,addr,msgId,message.data(),message.size());
+    EXPECT_GT(count,0) << "rdlc: fragmenter init failed";
+    std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(64,64));
+    int len;
+    while ((len = xRdlcFragmenterNext(&fragmenter,frame.data(),frame.size())) > 0)
+        frames.push_back(std::vector<uint8_t>(frame.begin(),frame.begin()+len));
+    EXPECT_EQ(len,0) << "rdlc: fragmenter next failed";
+    EXPECT_EQ((int)frames.size(),count);
+    return frames;
+}
+
+//========================================================================================
+
+/**
+ *@brief 1ԶmsgMaxSizeϢ֡󾭹xRdlcReadBytesԭϢһ£ϢҲռһ֡
+**/
+TEST(RdlcTestFragment, RoundTrip)
+{
+    Rdlc_t handle = RdlcFragmentCreate(64);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+    static uint8_t buffer[4096];
+    RdlcReassemblyConfig_t config = {
+        .buffer = buffer,
+        .bufferSize = sizeof(buffer),
+        .timeoutTicks = 0,
+        .cbMessage = RdlcFragmentOnMessage,
+    };
+    ASSERT_EQ(xRdlcReassemblyInit(handle,&FragmentReassembly,&config),RDLC_OK);
+
+    std::mt19937 rng(0xF4A6);
+    FragmentMessages.clear();
+    std::vector<std::vector<uint8_t>> expected;
+    for (int i = 0; i < 50; i++) {
+        std::vector<uint8_t> message(rng() % sizeof(buffer));
+        for (auto &b : message)
+            b = (rng() % 16 == 0) ? 0xFF : (rng() % 255);
+        expected.push_back(message);
+        for (auto &frame : RdlcFragmentSplit(handle,{0x01,0x02},(uint8_t)i,message))
+            xRdlcReadBytes(handle,frame.data(),frame.size());
+        EXPECT_EQ(FragmentLastResult,RDLC_OK) << "rdlc: message " << i;
+    }
+    EXPECT_EQ(FragmentMessages,expected);
+
+    FragmentMessages.clear();
+    for (auto &frame : RdlcFragmentSplit(handle,{0x01,0x02},0,{}))
+        xRdlcReadBytes(handle,frame.data(),frame.size());
+    ASSERT_EQ(FragmentMessages.size(),1u);
+    EXPECT_TRUE(FragmentMessages[0].empty());
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 2һƬʱϢһϢӰ죻ϢͳʱϢҲ
+**/
+TEST(RdlcTestFragment, LossAndTimeout)
+{
+    Rdlc_t handle = RdlcFragmentCreate(64);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+    static uint8_t buffer[1024];
+    RdlcReassemblyConfig_t config = {
+        .buffer = buffer,
+        .bufferSize = sizeof(buffer),
+        .timeoutTicks = 100,
+        .cbMessage = RdlcFragmentOnMessage,
+    };
+    ASSERT_EQ(xRdlcReassemblyInit(handle,&FragmentReassembly,&config),RDLC_OK);
+
+    std::vector<uint8_t> message(500);
+    for (size_t i = 0; i < message.size(); i++)
+        message[i] = (uint8_t)i;
+    FragmentMessages.clear();
+    FragmentTick = 0xFFFFFFF0u;
+
+    // 3Ƭ
+    std::vector<std::vector<uint8_t>> frames = RdlcFragmentSplit(handle,{0x01,0x02},1,message);
+    ASSERT_GT(frames.size(),3u);
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (i == 2)
+            continue;
+        xRdlcReadBytes(handle,frames[i].data(),frames[i].size());
+        if (i == 3) {
+            EXPECT_EQ(FragmentLastResult,RDLC_ERR_NOT_ALLOWED);
+        }
+    }
+    EXPECT_TRUE(FragmentMessages.empty()) << "rdlc: incomplete message delivered";
+
+    frames = RdlcFragmentSplit(handle,{0x01,0x02},2,message);
+    for (auto &frame : frames)
+        xRdlcReadBytes(handle,frame.data(),frame.size());
+    ASSERT_EQ(FragmentMessages.size(),1u);
+    EXPECT_EQ(FragmentMessages[0],message);
+
+    // ʱʱ
+    FragmentMessages.clear();
+    frames = RdlcFragmentSplit(handle,{0x01,0x02},3,message);
+    xRdlcReadBytes(handle,frames[0].data(),frames[0].size());
+    EXPECT_EQ(xRdlcReassemblyPoll(&FragmentReassembly,FragmentTick + 99),RDLC_OK);
+    EXPECT_EQ(xRdlcReassemblyPoll(&FragmentReassembly,FragmentTick + 100),RDLC_ERR_TIMEOUT);
+    for (size_t i = 1; i < frames.size(); i++)
+        xRdlcReadBytes(handle,frames[i].data(),frames[i].size());
+    EXPECT_TRUE(FragmentMessages.empty()) << "rdlc: timed out message delivered";
+
+    // 黺
+    std::vector<uint8_t> large(sizeof(buffer) + 1);
+    frames = RdlcFragmentSplit(handle,{0x01,0x02},4,large);
+    xRdlcReadBytes(handle,frames[0].data(),frames[0].size());
+    EXPECT_EQ(FragmentLastResult,RDLC_ERR_BUFFER_TOO_SHORT);
+    for (size_t i = 1; i < frames.size(); i++)
+        xRdlcReadBytes(handle,frames[i].data(),frames[i].size());
+    EXPECT_TRUE(FragmentMessages.empty()) << "rdlc: oversized message delivered";
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 3ṩ黺ʱϢportMalloc;ʼϢʱϢͷţ
+ *       bufferSizeƬװµܳڴ֮ǰܾ
+**/
+TEST(RdlcTestFragment, Malloc)
+{
+    Rdlc_t handle = RdlcFragmentCreate(64);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+    RdlcReassemblyConfig_t config = {
+        .buffer = NULL,
+        .bufferSize = 0,
+        .timeoutTicks = 0,
+        .cbMessage = RdlcFragmentOnMessage,
+    };
+    EXPECT_EQ(xRdlcReassemblyInit(handle,&FragmentReassembly,&config),RDLC_ERR_INVALID_ARG) << "rdlc: malloc mode without a limit";
+    config.bufferSize = 100000;
+    ASSERT_EQ(xRdlcReassemblyInit(handle,&FragmentReassembly,&config),RDLC_OK);
+
+    // ƬͷϢ Ƭ Ƭ ϢܳȣÿƬЯ64-9=55ֽ
+    const uint8_t hostile[] = {0x07,0x00,0x00,0x01,0x00,0xF0,0xFF,0xFF,0xFF};
+    EXPECT_EQ(xRdlcReassemblyFeed(&FragmentReassembly,{0x03,0x04},hostile,sizeof(hostile),0),RDLC_ERR_INVALID_ARG);
+    EXPECT_EQ(FragmentReassembly.message,nullptr);
+    const uint8_t manyHostile[] = {0x07,0x00,0x00,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF};
+    EXPECT_EQ(xRdlcReassemblyFeed(&FragmentReassembly,{0x03,0x04},manyHostile,sizeof(manyHostile),0),RDLC_ERR_INVALID_ARG);
+    EXPECT_EQ(FragmentReassembly.message,nullptr);
+    const uint8_t tooLong[] = {0x07,0x00,0x00,0xFF,0xFF,0xA1,0x86,0x01,0x00}; // 100001ֽڣƬװµ
+    EXPECT_EQ(xRdlcReassemblyFeed(&FragmentReassembly,{0x03,0x04},tooLong,sizeof(tooLong),0),RDLC_ERR_BUFFER_TOO_SHORT);
+    EXPECT_EQ(FragmentReassembly.message,nullptr);
+
+    std::vector<uint8_t> message(100000);
+    for (size_t i = 0; i < message.size(); i++)
+        message[i] = (uint8_t)(i * 7);
+    FragmentMessages.clear();
+
+    std::vector<std::vector<uint8_t>> abandoned = RdlcFragmentSplit(handle,{0x03,0x04},5,message);
+    for (size_t i = 0; i < abandoned.size() / 2; i++)
+        xRdlcReadBytes(handle,abandoned[i].data(),abandoned[i].size());
+    for (auto &frame : RdlcFragmentSplit(handle,{0x03,0x04},6,message))
+        xRdlcReadBytes(handle,frame.data(),frame.size());
+    ASSERT_EQ(FragmentMessages.size(),1u);
+    EXPECT_EQ(FragmentMessages[0],message);
+    EXPECT_EQ(FragmentReassembly.message,nullptr) << "rdlc: buffer not released";
+    vRdlcDestroy(handle);
+}
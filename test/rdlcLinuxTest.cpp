@@ -0,0 +1,433 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlc_linux.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief Linuxԣαն˶Ժsocketpair洮ڣշ˹ͬһ¼ѭ
+**/
+static std::map<Rdlc_t,std::vector<std::vector<uint8_t>>> LinuxRecords;
+static std::map<Rdlc_t,int> LinuxClosed;
+
+extern "C" int RdlcLinuxOnParsed(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    LinuxRecords[handle].push_back(std::vector<uint8_t>(data,data+size));
+    return 0;
+}
+
+extern "C" int RdlcLinuxOnClosed(Rdlc_t handle,RdlcLinuxLink_t *link,int err)
+{
+    LinuxClosed[handle]++;
+    return 0;
+}
+
+static Rdlc_t RdlcLinuxCreate(uint16_t msgMaxSize)
+{
+    RdlcConfig_t config = RdlcTestConfig(msgMaxSize);
+    config.cbParsed = RdlcLinuxOnParsed;
+    return RdlcTestCreate(config);
+}
+
+/**
+ *@brief һԭʼģʽαնˣfd[0]Ϊ豸fd[1]Ϊ豸
+**/
+static bool RdlcLinuxOpenPty(int fd[2])
+{
+    fd[0] = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd[0] < 0 || grantpt(fd[0]) != 0 || unlockpt(fd[0]) != 0)
+        return false;
+    fd[1] = open(ptsname(fd[0]),O_RDWR | O_NOCTTY);
+    if (fd[1] < 0)
+        return false;
+    struct termios tty;
+    tcgetattr(fd[1],&tty);
+    cfmakeraw(&tty);
+    return tcsetattr(fd[1],TCSANOW,&tty) == 0;
+}
+
+struct RdlcLinuxEnd_t
+{
+    Rdlc_t handle;
+    RdlcLinuxLink_t link;
+    std::vector<uint8_t> txBuf;
+};
+
+static void RdlcLinuxAddEnd(RdlcLinuxLoop_t *loop,RdlcLinuxEnd_t &end,int fd,uint16_t msgMaxSize,size_t txBufSize)
+{
+    end.handle = RdlcLinuxCreate(msgMaxSize);
+    ASSERT_NE(end.handle, nullptr) << "rdlc: init handle failed";
+    end.txBuf.resize(txBufSize);
+    RdlcLinuxLinkConfig_t config = {
+        .fd = fd,
+        .protoHandle = end.handle,
+        .txBuf = end.txBuf.data(),
+        .txBufSize = end.txBuf.size(),
+        .cbClosed = RdlcLinuxOnClosed,
+    };
+    ASSERT_EQ(xRdlcLinuxLinkAdd(loop,&end.link,&config),RDLC_OK);
+}
+
+//========================================================================================
+
+/**
+ *@brief 14αն˹8·һ¼ѭÿ·Զ֡Զ˰˳յÿread()ض֡
+**/
+TEST(RdlcTestLinux, ManyPty)
+{
+    const int pairs = 4;
+    const uint16_t msgMaxSize = 256;
+    static uint8_t rxBuf[RDLC_LINUX_RX_BUF_SIZE];
+    RdlcLinuxLoop_t loop;
+    ASSERT_EQ(xRdlcLinuxLoopInit(&loop,rxBuf,sizeof(rxBuf)),RDLC_OK);
+
+    std::vector<RdlcLinuxEnd_t> ends(pairs * 2);
+    std::vector<int> fds(pairs * 2);
+    for (int p = 0; p < pairs; p++) {
+        ASSERT_TRUE(RdlcLinuxOpenPty(&fds[p * 2])) << "rdlc: openpty failed";
+        RdlcLinuxAddEnd(&loop,ends[p * 2],fds[p * 2],msgMaxSize,1 << 16);
+        RdlcLinuxAddEnd(&loop,ends[p * 2 + 1],fds[p * 2 + 1],msgMaxSize,1 << 16);
+    }
+
+    std::mt19937 rng(0x11AB);
+    std::map<Rdlc_t,std::vector<std::vector<uint8_t>>> expected;
+    LinuxRecords.clear();
+    for (int i = 0; i < 200; i++) {
+        for (size_t e = 0; e < ends.size(); e++) {
+            std::vector<uint8_t> payload(1 + rng() % msgMaxSize);
+            for (auto &b : payload)
+                b = (rng() % 8 == 0) ? 0xFF : (uint8_t)rng();
+            RdlcLinuxEnd_t &peer = ends[e ^ 1];
+            if (xRdlcLinuxSend(&loop,&ends[e].link,{(uint8_t)e,(uint8_t)(e ^ 1)},payload.data(),payload.size()) == RDLC_OK)
+                expected[peer.handle].push_back(payload);
+        }
+    }
+    for (int spin = 0; spin < 1000 && LinuxRecords != expected; spin++)
+        xRdlcLinuxLoopRun(&loop,10);
+
+    for (auto &end : ends) {
+        ASSERT_FALSE(expected[end.handle].empty());
+        EXPECT_EQ(LinuxRecords[end.handle],expected[end.handle]) << "rdlc: frames lost or reordered";
+        EXPECT_LT(end.link.rxSyscalls,expected[end.handle].size()) << "rdlc: reads not batched";
+    }
+    for (auto &end : ends) {
+        xRdlcLinuxLinkRemove(&loop,&end.link);
+        vRdlcDestroy(end.handle);
+    }
+    for (int fd : fds)
+        close(fd);
+    vRdlcLinuxLoopDeinit(&loop);
+}
+
+//========================================================================================
+
+/**
+ *@brief 2Զ˲ʱͶдܾ֡ӵ֡ڶԶ˻ָȡ󾭲дʹԶ˹رʱص֪ͨ
+**/
+TEST(RdlcTestLinux, PartialWrite)
+{
+    const uint16_t msgMaxSize = 1000;
+    static uint8_t rxBuf[RDLC_LINUX_RX_BUF_SIZE];
+    RdlcLinuxLoop_t loop;
+    ASSERT_EQ(xRdlcLinuxLoopInit(&loop,rxBuf,sizeof(rxBuf)),RDLC_OK);
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX,SOCK_STREAM,0,fds),0);
+    int sndBuf = 4096;
+    setsockopt(fds[0],SOL_SOCKET,SO_SNDBUF,&sndBuf,sizeof(sndBuf));
+
+    RdlcLinuxEnd_t tx, rx;
+    RdlcLinuxAddEnd(&loop,tx,fds[0],msgMaxSize,16384);
+    rx.handle = RdlcLinuxCreate(msgMaxSize);
+    ASSERT_NE(rx.handle, nullptr);
+
+    // ն˻û¼ѭݶں˺ͷͶ
+    std::mt19937 rng(0x9A27);
+    std::vector<std::vector<uint8_t>> expected;
+    int rejected = 0;
+    for (int i = 0; i < 200; i++) {
+        std::vector<uint8_t> payload(msgMaxSize / 2 + rng() % (msgMaxSize / 2));
+        for (auto &b : payload)
+            b = (rng() % 4 == 0) ? 0xFF : (uint8_t)rng();
+        int ret = xRdlcLinuxSend(&loop,&tx.link,{0x01,0x02},payload.data(),payload.size());
+        if (ret == RDLC_OK)
+            expected.push_back(payload);
+        else {
+            EXPECT_EQ(ret,RDLC_ERR_BUFFER_TOO_SHORT);
+            rejected++;
+        }
+        xRdlcLinuxLoopRun(&loop,0);
+    }
+    EXPECT_GT(rejected,0) << "rdlc: queue never filled";
+    EXPECT_TRUE(tx.link.txArmed) << "rdlc: partial write not pending";
+
+    LinuxRecords.clear();
+    rx.txBuf.resize(1024);
+    RdlcLinuxLinkConfig_t config = {
+        .fd = fds[1],
+        .protoHandle = rx.handle,
+        .txBuf = rx.txBuf.data(),
+        .txBufSize = rx.txBuf.size(),
+        .cbClosed = RdlcLinuxOnClosed,
+    };
+    ASSERT_EQ(xRdlcLinuxLinkAdd(&loop,&rx.link,&config),RDLC_OK);
+    for (int spin = 0; spin < 1000 && LinuxRecords[rx.handle].size() < expected.size(); spin++)
+        xRdlcLinuxLoopRun(&loop,10);
+    EXPECT_EQ(LinuxRecords[rx.handle],expected) << "rdlc: frames lost or reordered";
+    EXPECT_FALSE(tx.link.txArmed) << "rdlc: EPOLLOUT still armed";
+    EXPECT_EQ(tx.link.txBytes,rx.link.rxBytes);
+
+    LinuxClosed.clear();
+    xRdlcLinuxLinkRemove(&loop,&tx.link);
+    close(fds[0]);
+    for (int spin = 0; spin < 100 && LinuxClosed[rx.handle] == 0; spin++)
+        xRdlcLinuxLoopRun(&loop,10);
+    EXPECT_EQ(LinuxClosed[rx.handle],1) << "rdlc: hangup not reported";
+    EXPECT_EQ(rx.link.state,RDLC_LINUX_LINK_CLOSED);
+    EXPECT_EQ(xRdlcLinuxSend(&loop,&rx.link,{0x02,0x01},rxBuf,1),RDLC_ERR_NOT_ALLOWED);
+
+    close(fds[1]);
+    vRdlcDestroy(tx.handle);
+    vRdlcDestroy(rx.handle);
+    vRdlcLinuxLoopDeinit(&loop);
+}
+
+//========================================================================================
+
+/**
+ *@brief 3io_uringˣ2αն˫֡Զ˰˳յϵͳôԶ֡ں˲֧ʱ
+**/
+TEST(RdlcTestLinux, UringPty)
+{
+    const int pairs = 2;
+    const uint16_t msgMaxSize = 256;
+    static uint8_t rxBufs[RDLC_LINUX_URING_RX_BUF_COUNT][RDLC_LINUX_URING_RX_BUF_SIZE];
+    RdlcLinuxUring_t ring;
+    if (xRdlcLinuxUringInit(&ring,&rxBufs[0][0],RDLC_LINUX_URING_RX_BUF_SIZE,RDLC_LINUX_URING_RX_BUF_COUNT) != RDLC_OK)
+        GTEST_SKIP() << "rdlc: io_uring not available";
+
+    std::vector<RdlcLinuxEnd_t> ends(pairs * 2);
+    std::vector<int> fds(pairs * 2);
+    for (int p = 0; p < pairs; p++) {
+        ASSERT_TRUE(RdlcLinuxOpenPty(&fds[p * 2])) << "rdlc: openpty failed";
+        for (int e = p * 2; e < p * 2 + 2; e++) {
+            ends[e].handle = RdlcLinuxCreate(msgMaxSize);
+            ASSERT_NE(ends[e].handle, nullptr) << "rdlc: init handle failed";
+            ends[e].txBuf.resize(1 << 16);
+            RdlcLinuxLinkConfig_t config = {
+                .fd = fds[e],
+                .protoHandle = ends[e].handle,
+                .txBuf = ends[e].txBuf.data(),
+                .txBufSize = ends[e].txBuf.size(),
+                .cbClosed = RdlcLinuxOnClosed,
+            };
+            ASSERT_EQ(xRdlcLinuxUringLinkAdd(&ring,&ends[e].link,&config),RDLC_OK);
+        }
+    }
+
+    std::mt19937 rng(0x0A1B);
+    std::map<Rdlc_t,std::vector<std::vector<uint8_t>>> expected;
+    size_t frames = 0;
+    LinuxRecords.clear();
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 20; i++) {
+            for (size_t e = 0; e < ends.size(); e++) {
+                std::vector<uint8_t> payload(1 + rng() % msgMaxSize);
+                for (auto &b : payload)
+                    b = (rng() % 8 == 0) ? 0xFF : (uint8_t)rng();
+                if (xRdlcLinuxUringSend(&ring,&ends[e].link,{(uint8_t)e,(uint8_t)(e ^ 1)},payload.data(),payload.size()) == RDLC_OK) {
+                    expected[ends[e ^ 1].handle].push_back(payload);
+                    frames++;
+                }
+            }
+        }
+        xRdlcLinuxUringRun(&ring,0);
+    }
+    for (int spin = 0; spin < 1000 && LinuxRecords != expected; spin++)
+        xRdlcLinuxUringRun(&ring,10);
+
+    for (auto &end : ends) {
+        ASSERT_FALSE(expected[end.handle].empty());
+        EXPECT_EQ(LinuxRecords[end.handle],expected[end.handle]) << "rdlc: frames lost or reordered";
+        EXPECT_EQ(end.link.txHead,end.link.txTail) << "rdlc: tx queue not drained";
+    }
+    EXPECT_LT(ring.enterSyscalls,frames / 4) << "rdlc: submissions not batched";
+
+    LinuxClosed.clear();
+    for (auto &end : ends) {
+        EXPECT_EQ(xRdlcLinuxUringLinkRemove(&ring,&end.link),RDLC_OK);
+        EXPECT_EQ(end.link.uringOps,0);
+        vRdlcDestroy(end.handle);
+    }
+    EXPECT_TRUE(LinuxClosed.empty()) << "rdlc: removal reported as hangup";
+    for (int fd : fds)
+        close(fd);
+    vRdlcLinuxUringDeinit(&ring);
+}
+
+/**
+ *@brief һʹ10֡3֡غзתһλ6֡һ벹֡βӦյ8֡
+**/
+static std::vector<uint8_t> RdlcLinuxCorruptBurst(Rdlc_t txHandle,std::vector<std::vector<uint8_t>> &expected)
+{
+    std::vector<uint8_t> burst;
+    for (int i = 0; i < 10; i++) {
+        std::vector<uint8_t> payload(40 + i);
+        for (size_t k = 0; k < payload.size(); k++)
+            payload[k] = (uint8_t)(i * 16 + k);
+        std::vector<uint8_t> frame = RdlcTestEncode(txHandle,payload);
+        if (i == 3)
+            frame[8] ^= 0x01;
+        else if (i == 6) {
+            frame.resize(frame.size() / 2);
+            frame.insert(frame.end(),{0xFF,0x0C});
+        }
+        else
+            expected.push_back(payload);
+        burst.insert(burst.end(),frame.begin(),frame.end());
+    }
+    return burst;
+}
+
+//========================================================================================
+
+/**
+ *@brief 4һread()мгֻ֡֡֡ճյ
+**/
+TEST(RdlcTestLinux, CorruptBurst)
+{
+    const uint16_t msgMaxSize = 256;
+    static uint8_t rxBuf[RDLC_LINUX_RX_BUF_SIZE];
+    RdlcLinuxLoop_t loop;
+    ASSERT_EQ(xRdlcLinuxLoopInit(&loop,rxBuf,sizeof(rxBuf)),RDLC_OK);
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX,SOCK_STREAM,0,fds),0);
+    Rdlc_t txHandle = RdlcLinuxCreate(msgMaxSize);
+    ASSERT_NE(txHandle,nullptr);
+    std::vector<std::vector<uint8_t>> expected;
+    std::vector<uint8_t> burst = RdlcLinuxCorruptBurst(txHandle,expected);
+    ASSERT_EQ(write(fds[0],burst.data(),burst.size()),(ssize_t)burst.size());
+
+    LinuxRecords.clear();
+    RdlcLinuxEnd_t rx;
+    RdlcLinuxAddEnd(&loop,rx,fds[1],msgMaxSize,1024);
+    for (int spin = 0; spin < 100 && LinuxRecords[rx.handle].size() < expected.size(); spin++)
+        xRdlcLinuxLoopRun(&loop,10);
+    EXPECT_EQ(LinuxRecords[rx.handle],expected) << "rdlc: frames after the bad one lost";
+    EXPECT_EQ(rx.link.rxSyscalls,1u) << "rdlc: burst not read at once";
+    EXPECT_EQ(rx.link.rxErrors,1u);
+
+    xRdlcLinuxLinkRemove(&loop,&rx.link);
+    close(fds[0]);
+    close(fds[1]);
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rx.handle);
+    vRdlcLinuxLoopDeinit(&loop);
+}
+
+//========================================================================================
+
+/**
+ *@brief 5io_uringˣһζмгֻ֡֡ں˲֧ʱ
+**/
+TEST(RdlcTestLinux, UringCorruptBurst)
+{
+    const uint16_t msgMaxSize = 256;
+    static uint8_t rxBufs[RDLC_LINUX_URING_RX_BUF_COUNT][RDLC_LINUX_URING_RX_BUF_SIZE];
+    RdlcLinuxUring_t ring;
+    if (xRdlcLinuxUringInit(&ring,&rxBufs[0][0],RDLC_LINUX_URING_RX_BUF_SIZE,RDLC_LINUX_URING_RX_BUF_COUNT) != RDLC_OK)
+        GTEST_SKIP() << "rdlc: io_uring not available";
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX,SOCK_STREAM,0,fds),0);
+    Rdlc_t txHandle = RdlcLinuxCreate(msgMaxSize);
+    ASSERT_NE(txHandle,nullptr);
+    std::vector<std::vector<uint8_t>> expected;
+    std::vector<uint8_t> burst = RdlcLinuxCorruptBurst(txHandle,expected);
+    ASSERT_LE(burst.size(),(size_t)RDLC_LINUX_URING_RX_BUF_SIZE);
+    ASSERT_EQ(write(fds[0],burst.data(),burst.size()),(ssize_t)burst.size());
+
+    LinuxRecords.clear();
+    RdlcLinuxEnd_t rx;
+    rx.handle = RdlcLinuxCreate(msgMaxSize);
+    ASSERT_NE(rx.handle,nullptr);
+    rx.txBuf.resize(1024);
+    RdlcLinuxLinkConfig_t config = {
+        .fd = fds[1],
+        .protoHandle = rx.handle,
+        .txBuf = rx.txBuf.data(),
+        .txBufSize = rx.txBuf.size(),
+        .cbClosed = RdlcLinuxOnClosed,
+    };
+    ASSERT_EQ(xRdlcLinuxUringLinkAdd(&ring,&rx.link,&config),RDLC_OK);
+    for (int spin = 0; spin < 100 && LinuxRecords[rx.handle].size() < expected.size(); spin++)
+        xRdlcLinuxUringRun(&ring,10);
+    EXPECT_EQ(LinuxRecords[rx.handle],expected) << "rdlc: frames after the bad one lost";
+    EXPECT_EQ(rx.link.rxBytes,burst.size());
+    EXPECT_EQ(rx.link.rxErrors,1u);
+
+    EXPECT_EQ(xRdlcLinuxUringLinkRemove(&ring,&rx.link),RDLC_OK);
+    close(fds[0]);
+    close(fds[1]);
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rx.handle);
+    vRdlcLinuxUringDeinit(&ring);
+}
+
+/**
+ *@brief 6io_uringύȡŲȥʱƳ·شһֱȴٴƳʱȡɹ
+**/
+TEST(RdlcTestLinux, UringRemoveQueueFull)
+{
+    const uint16_t msgMaxSize = 256;
+    static uint8_t rxBufs[RDLC_LINUX_URING_RX_BUF_COUNT][RDLC_LINUX_URING_RX_BUF_SIZE];
+    RdlcLinuxUring_t ring;
+    if (xRdlcLinuxUringInit(&ring,&rxBufs[0][0],RDLC_LINUX_URING_RX_BUF_SIZE,RDLC_LINUX_URING_RX_BUF_COUNT) != RDLC_OK)
+        GTEST_SKIP() << "rdlc: io_uring not available";
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX,SOCK_STREAM,0,fds),0);
+    RdlcLinuxEnd_t rx;
+    rx.handle = RdlcLinuxCreate(msgMaxSize);
+    ASSERT_NE(rx.handle,nullptr);
+    rx.txBuf.resize(1024);
+    RdlcLinuxLinkConfig_t config = {
+        .fd = fds[1],
+        .protoHandle = rx.handle,
+        .txBuf = rx.txBuf.data(),
+        .txBufSize = rx.txBuf.size(),
+        .cbClosed = RdlcLinuxOnClosed,
+    };
+    ASSERT_EQ(xRdlcLinuxUringLinkAdd(&ring,&rx.link,&config),RDLC_OK);
+    xRdlcLinuxUringRun(&ring,0);
+    ASSERT_EQ(rx.link.uringOps,1u) << "rdlc: read not in kernel";
+
+    // ںȡߵλͣһȦ֮ǰύпһֱ
+    uint32_t *sqHead = ring.sqHead;
+    uint32_t fullHead = ring.sqLocalTail - ring.sqEntries;
+    ring.sqHead = &fullHead;
+    EXPECT_EQ(xRdlcLinuxUringLinkRemove(&ring,&rx.link),RDLC_ERR_IO);
+    ring.sqHead = sqHead;
+    EXPECT_EQ(rx.link.state,RDLC_LINUX_LINK_CLOSED);
+    EXPECT_EQ(rx.link.uringOps,1u);
+
+    EXPECT_EQ(xRdlcLinuxUringLinkRemove(&ring,&rx.link),RDLC_OK);
+    EXPECT_EQ(rx.link.state,RDLC_LINUX_LINK_IDLE);
+    EXPECT_EQ(rx.link.uringOps,0u);
+    close(fds[0]);
+    close(fds[1]);
+    vRdlcDestroy(rx.handle);
+    vRdlcLinuxUringDeinit(&ring);
+}
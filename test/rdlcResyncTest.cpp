@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief ͬԣͶ֡м䱻ϡֶʱ֡Ӧ
+**/
+
+/**
+ *@brief ĩβǷͣתַǰһϣʱһ֡֡ͷת0xFF޷֣Щضλ
+**/
+static bool RdlcResyncHalfEscape(const std::vector<uint8_t> &data)
+{
+    size_t run = 0;
+    while (run < data.size() && data[data.size() - 1 - run] == 0xFF)
+        run++;
+    return run & 1;
+}
+
+TEST(RdlcTestResync, TruncatedFrame)
+{
+    const uint16_t flagsList[] = {0,RDLC_FLAG_RX_ZERO_COPY};
+    for (uint16_t flags : flagsList)
+    for (int bulk = 0; bulk < 2; bulk++) {
+        Rdlc_t handle = RdlcTestCreate(64,flags);
+        ASSERT_NE(handle,nullptr) << "rdlc: init handle failed";
+        std::vector<uint8_t> cutPayload = {0x11,0xFF,0x22,0xFF,0xFF,0x33,0x44};
+        std::vector<uint8_t> nextPayload = {0x55,0x66,0xFF,0x77};
+        std::vector<uint8_t> cutFrame = RdlcTestEncode(handle,cutPayload);
+        std::vector<uint8_t> nextFrame = RdlcTestEncode(handle,nextPayload);
+
+        // ֡ͷ֮֡β֮ǰÿλýضϣͣCRC֮֡β֮ǰ
+        for (size_t cut = 2; cut < cutFrame.size() - 1; cut++) {
+            std::vector<uint8_t> stream(cutFrame.begin(),cutFrame.begin() + cut);
+            if (RdlcResyncHalfEscape(stream))
+                continue;
+            stream.insert(stream.end(),nextFrame.begin(),nextFrame.end());
+
+            RdlcTestRecords.clear();
+            if (bulk) {
+                EXPECT_EQ(xRdlcReadBytes(handle,stream.data(),stream.size()),RDLC_OK) << "rdlc: cut at " << cut;
+            }
+            else {
+                for (uint8_t byte : stream)
+                    xRdlcReadByte(handle,byte);
+            }
+            ASSERT_EQ(RdlcTestRecords.size(),1u) << "rdlc: cut at " << cut;
+            EXPECT_EQ(RdlcTestRecords[0],nextPayload) << "rdlc: cut at " << cut;
+            EXPECT_EQ(xRdlcGetParseState(handle),RDLC_STATE_PARSE_WAIT_HEAD);
+        }
+        vRdlcDestroy(handle);
+    }
+}
+
+TEST(RdlcTestResync, WideHead)
+{
+    Rdlc_t handle = RdlcTestCreate(64,RDLC_FLAG_WIDE_LENGTH);
+    ASSERT_NE(handle,nullptr) << "rdlc: init handle failed";
+    std::vector<uint8_t> payload = {0x01,0x02,0x03};
+    std::vector<uint8_t> frame = RdlcTestEncode(handle,payload);
+
+    // ֡ͷͬԴһ֡
+    std::vector<uint8_t> stream(frame.begin(),frame.begin() + 6);
+    stream.insert(stream.end(),{0xFF,0xC1,0x01,0x02,0x03,0x00,0x00,0x00});
+    stream.insert(stream.end(),frame.begin() + 6,frame.end());
+    RdlcTestRecords.clear();
+    for (uint8_t byte : stream)
+        xRdlcReadByte(handle,byte);
+    ASSERT_EQ(RdlcTestRecords.size(),1u);
+    EXPECT_EQ(RdlcTestRecords[0],payload);
+    vRdlcDestroy(handle);
+}
+
+TEST(RdlcTestResync, EarlyTail)
+{
+    Rdlc_t handle = RdlcTestCreate(64);
+    ASSERT_NE(handle,nullptr) << "rdlc: init handle failed";
+    std::vector<uint8_t> payload = {0x0C,0x0C,0x0C,0x0C};
+    std::vector<uint8_t> frame = RdlcTestEncode(handle,payload);
+
+    // Ͷ˷һ֡󲹷֡β
+    std::vector<uint8_t> stream(frame.begin(),frame.begin() + 8);
+    stream.insert(stream.end(),{0xFF,0x0C});
+    RdlcTestRecords.clear();
+    EXPECT_EQ(xRdlcReadBytes(handle,stream.data(),stream.size()),RDLC_ERR_CRC);
+    EXPECT_EQ(xRdlcGetParseState(handle),RDLC_STATE_PARSE_WAIT_HEAD);
+    EXPECT_EQ(xRdlcReadBytes(handle,frame.data(),frame.size()),RDLC_OK);
+    ASSERT_EQ(RdlcTestRecords.size(),1u);
+    EXPECT_EQ(RdlcTestRecords[0],payload);
+
+    // ضϵ֡һ֡ͬһУ󣬵֡ճյ
+    stream.insert(stream.end(),frame.begin(),frame.end());
+    RdlcTestRecords.clear();
+    EXPECT_EQ(xRdlcReadBytes(handle,stream.data(),stream.size()),RDLC_ERR_CRC);
+    ASSERT_EQ(RdlcTestRecords.size(),1u);
+    EXPECT_EQ(RdlcTestRecords[0],payload);
+    vRdlcDestroy(handle);
+}
+
+TEST(RdlcTestResync, InvalidLength)
+{
+    Rdlc_t handle = RdlcTestCreate(64);
+    ASSERT_NE(handle,nullptr) << "rdlc: init handle failed";
+    std::vector<uint8_t> payload = {0x10,0x20,0x30,0x40};
+    std::vector<uint8_t> frame = RdlcTestEncode(handle,payload);
+
+    // FF C0 Դַ Ŀĵַ ȵ ȸߣmsgMaxSizeĳյʱͱܾ
+    const uint16_t badLengths[] = {65,0x7F10};
+    for (uint16_t badLength : badLengths) {
+        std::vector<uint8_t> bad = frame;
+        bad[4] = badLength & 0xFF;
+        bad[5] = badLength >> 8;
+        RdlcTestRecords.clear();
+        int res = RDLC_NOT_FINISH;
+        for (size_t i = 0; i < 6; i++)
+            res = xRdlcReadByte(handle,bad[i]);
+        EXPECT_EQ(res,RDLC_ERR_NOT_ALLOWED) << "rdlc: length " << badLength;
+        EXPECT_EQ(xRdlcGetParseState(handle),RDLC_STATE_PARSE_SKIP);
+        for (size_t i = 6; i < bad.size(); i++)
+            xRdlcReadByte(handle,bad[i]);
+        EXPECT_TRUE(RdlcTestRecords.empty());
+
+        // 𻵵֡û֡βʱһ֡֡ͷҲܽ
+        std::vector<uint8_t> stream(bad.begin(),bad.begin() + 8);
+        stream.insert(stream.end(),frame.begin(),frame.end());
+        for (uint8_t byte : stream)
+            xRdlcReadByte(handle,byte);
+        ASSERT_EQ(RdlcTestRecords.size(),1u) << "rdlc: length " << badLength;
+        EXPECT_EQ(RdlcTestRecords[0],payload);
+    }
+    vRdlcDestroy(handle);
+}
+
+TEST(RdlcTestResync, OverMaxZeroCopy)
+{
+    // ջܱmsgMaxSizeҪĸ֡6ֽͷԤ̬ʵԴĻ
+    Rdlc_t txHandle = RdlcTestCreate(128);
+    ASSERT_NE(txHandle,nullptr) << "rdlc: init handle failed";
+    std::vector<uint8_t> payload = {0x10,0x20,0x30};
+    std::vector<uint8_t> over = RdlcTestEncode(txHandle,std::vector<uint8_t>(66,0x5A));
+    std::vector<uint8_t> frame = RdlcTestEncode(txHandle,payload);
+    RdlcPort_t port = RdlcTestPort();
+
+    static RdlcStaticHandle_t staticHandles[2];
+    static uint8_t staticRxBuffers[2][256];
+    for (int kind = 0; kind < 2; kind++) {
+        int results[2];
+        std::vector<std::vector<uint8_t>> records[2];
+        for (int zeroCopy = 0; zeroCopy < 2; zeroCopy++) {
+            uint16_t flags = zeroCopy ? RDLC_FLAG_RX_ZERO_COPY : 0;
+            Rdlc_t handle;
+            if (kind == 0)
+                handle = RdlcTestCreate(64,flags | RDLC_FLAG_WIDE_LENGTH);
+            else {
+                RdlcConfig_t config = RdlcTestConfig(64,flags);
+                handle = xRdlcCreateStatic(&config,&port,&staticHandles[zeroCopy],staticRxBuffers[zeroCopy],sizeof(staticRxBuffers[zeroCopy]));
+            }
+            ASSERT_NE(handle,nullptr) << "rdlc: init handle failed";
+            RdlcTestRecords.clear();
+            results[zeroCopy] = xRdlcReadBytes(handle,over.data(),over.size());
+            EXPECT_EQ(xRdlcReadBytes(handle,frame.data(),frame.size()),RDLC_OK);
+            records[zeroCopy] = RdlcTestRecords;
+            if (kind == 0)
+                vRdlcDestroy(handle);
+        }
+        EXPECT_EQ(results[0],RDLC_ERR_NOT_ALLOWED) << "rdlc: kind " << kind;
+        EXPECT_EQ(results[1],results[0]) << "rdlc: zero-copy differs, kind " << kind;
+        ASSERT_EQ(records[0].size(),1u) << "rdlc: kind " << kind;
+        EXPECT_EQ(records[0][0],payload);
+        EXPECT_EQ(records[1],records[0]) << "rdlc: zero-copy differs, kind " << kind;
+    }
+    vRdlcDestroy(txHandle);
+}
+
+TEST(RdlcTestResync, RandomCuts)
+{
+    Rdlc_t handle = RdlcTestCreate(64,RDLC_FLAG_RX_ZERO_COPY);
+    ASSERT_NE(handle,nullptr) << "rdlc: init handle failed";
+    std::mt19937 rng(20260516);
+    std::vector<uint8_t> stream;
+    std::vector<std::vector<uint8_t>> expected;
+    for (int i = 0; i < 500; i++) {
+        std::vector<uint8_t> payload(1 + rng() % 64);
+        for (auto &b : payload)
+            b = (rng() % 5 == 0) ? 0xFF : (uint8_t)rng();
+        std::vector<uint8_t> frame = RdlcTestEncode(handle,payload);
+        // ض(һ벹֡β)ڳȡغɡCRCзתһλCRCǵַתַ֡Իᱻյ
+        size_t frameSize = frame.size();
+        switch (rng() % 10) {
+            case 0:
+            case 1:
+                frame.resize(2 + rng() % (frameSize - 3));
+                if (RdlcResyncHalfEscape(frame))
+                    frame.pop_back();
+                // һCRCֽڲŲ֡βϵһ֡
+                if (frame.size() + 5 <= frameSize && rng() % 2)
+                    frame.insert(frame.end(),{0xFF,0x0C});
+            break;
+            case 2:
+                frame[4 + rng() % (frameSize - 6)] ^= 1u << (rng() % 8);
+            break;
+            default:
+                expected.push_back(payload);
+            break;
+        }
+        stream.insert(stream.end(),frame.begin(),frame.end());
+    }
+
+    // 룺ֻ֡Լͬһк֡ճյ
+    RdlcTestRecords.clear();
+    int errors = 0;
+    for (size_t pos = 0; pos < stream.size();) {
+        size_t chunk = std::min<size_t>(1 + rng() % 200,stream.size() - pos);
+        if (xRdlcReadBytes(handle,&stream[pos],chunk) < 0)
+            errors++;
+        pos += chunk;
+    }
+    EXPECT_GT(errors,0);
+    EXPECT_EQ(RdlcTestRecords,expected);
+    vRdlcDestroy(handle);
+}
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief ֽڻԣһ߳ģ⴮ждֽڣһ߳ģȡ
+**/
+
+/**
+ *@brief ߺ߸԰ͬһֽУֽڱȶ
+**/
+static uint8_t RdlcRingStreamByte(uint32_t index)
+{
+    uint32_t x = index * 2654435761u;
+    return (uint8_t)(x ^ (x >> 13) ^ (x >> 24));
+}
+
+TEST(RdlcTestRing, Basic)
+{
+    uint8_t buffer[16];
+    RdlcRing_t ring;
+    EXPECT_EQ(xRdlcRingInit(&ring,buffer,12),RDLC_ERR_INVALID_ARG);
+    EXPECT_EQ(xRdlcRingInit(&ring,NULL,16),RDLC_ERR_INVALID_ARG);
+    ASSERT_EQ(xRdlcRingInit(&ring,buffer,sizeof(buffer)),RDLC_OK);
+
+    const uint8_t *data;
+    EXPECT_EQ(xRdlcRingPeek(&ring,&data),0u);
+
+    // дֽڱ
+    uint8_t input[20];
+    for (int i = 0; i < 20; i++)
+        input[i] = i;
+    EXPECT_EQ(xRdlcRingPush(&ring,input,10),10u);
+    EXPECT_EQ(xRdlcRingPush(&ring,&input[10],10),6u);
+    EXPECT_EQ(xRdlcRingPushByte(&ring,0xAA),RDLC_ERR_BUFFER_TOO_SHORT);
+    EXPECT_EQ(ring.dropped,5u);
+
+    ASSERT_EQ(xRdlcRingPeek(&ring,&data),16u);
+    EXPECT_EQ(memcmp(data,input,16),0);
+    vRdlcRingConsume(&ring,12);
+
+    // ĩβݷȡ
+    EXPECT_EQ(xRdlcRingPushByte(&ring,0xAA),RDLC_OK);
+    EXPECT_EQ(xRdlcRingPush(&ring,input,8),8u);
+    ASSERT_EQ(xRdlcRingPeek(&ring,&data),4u);
+    EXPECT_EQ(memcmp(data,&input[12],4),0);
+    vRdlcRingConsume(&ring,4);
+    ASSERT_EQ(xRdlcRingPeek(&ring,&data),9u);
+    EXPECT_EQ(data[0],0xAA);
+    EXPECT_EQ(memcmp(&data[1],input,8),0);
+    vRdlcRingConsume(&ring,9);
+    EXPECT_EQ(xRdlcRingPeek(&ring,&data),0u);
+}
+
+TEST(RdlcTestRing, TwoThreadStress)
+{
+    // СƵ߽ʹֽںд룻ûнչʱóCPU˻Ҳ
+    const uint32_t total = 1u << 22;
+    static uint8_t buffer[64];
+    RdlcRing_t ring;
+    ASSERT_EQ(xRdlcRingInit(&ring,buffer,sizeof(buffer)),RDLC_OK);
+
+    std::thread producer([&]() {
+        std::mt19937 rng(20);
+        uint8_t chunk[48];
+        uint32_t index = 0;
+        while (index < total) {
+            if (rng() & 1) {
+                if (xRdlcRingPushByte(&ring,RdlcRingStreamByte(index)) == RDLC_OK)
+                    index++;
+                else
+                    std::this_thread::yield();
+                continue;
+            }
+            uint32_t size = 1 + rng() % sizeof(chunk);
+            if (size > total - index)
+                size = total - index;
+            for (uint32_t i = 0; i < size; i++)
+                chunk[i] = RdlcRingStreamByte(index + i);
+            // дµĲֻᱻֻǰʵдĳȣ´
+            uint32_t count = xRdlcRingPush(&ring,chunk,size);
+            if (count == 0)
+                std::this_thread::yield();
+            index += count;
+        }
+    });
+
+    uint32_t index = 0;
+    uint32_t mismatch = 0;
+    while (index < total) {
+        const uint8_t *data;
+        uint32_t size = xRdlcRingPeek(&ring,&data);
+        if (size == 0)
+            std::this_thread::yield();
+        for (uint32_t i = 0; i < size; i++)
+            mismatch += (data[i] != RdlcRingStreamByte(index + i));
+        index += size;
+        vRdlcRingConsume(&ring,size);
+    }
+    producer.join();
+    EXPECT_EQ(index,total);
+    EXPECT_EQ(mismatch,0u);
+    EXPECT_EQ(ring.head,total);
+    EXPECT_EQ(ring.tail,total);
+}
+
+TEST(RdlcTestRing, DrainFrames)
+{
+    // ж̰߳ѱõֽ֡д룬߳ͨպ㿽ոһ
+    for (uint16_t flags : {(uint16_t)0,(uint16_t)RDLC_FLAG_RX_ZERO_COPY}) {
+        Rdlc_t txHandle = RdlcTestCreate(200,flags);
+        Rdlc_t rxHandle = RdlcTestCreate(200,flags);
+        ASSERT_NE(txHandle,nullptr);
+        ASSERT_NE(rxHandle,nullptr);
+
+        std::mt19937 rng(flags);
+        std::vector<std::vector<uint8_t>> payloads;
+        std::vector<uint8_t> stream;
+        for (int i = 0; i < 2000; i++) {
+            std::vector<uint8_t> payload(1 + rng() % 200);
+            for (auto &b : payload)
+                b = (rng() % 8 == 0) ? 0xFF : (uint8_t)rng();
+            std::vector<uint8_t> frame = RdlcTestEncode(txHandle,payload);
+            stream.insert(stream.end(),frame.begin(),frame.end());
+            payloads.push_back(payload);
+        }
+
+        static uint8_t buffer[256];
+        RdlcRing_t ring;
+        ASSERT_EQ(xRdlcRingInit(&ring,buffer,sizeof(buffer)),RDLC_OK);
+        RdlcTestRecords.clear();
+        std::atomic<bool> done(false);
+        std::thread isr([&]() {
+            for (size_t i = 0; i < stream.size();) {
+                if (xRdlcRingPushByte(&ring,stream[i]) == RDLC_OK)
+                    i++;
+                else
+                    std::this_thread::yield();
+            }
+            done.store(true,std::memory_order_release);
+        });
+        while (!done.load(std::memory_order_acquire)) {
+            EXPECT_THAT(xRdlcRingDrain(rxHandle,&ring),::testing::AnyOf(RDLC_OK,RDLC_NOT_FINISH));
+            std::this_thread::yield();
+        }
+        xRdlcRingDrain(rxHandle,&ring);
+        isr.join();
+
+        EXPECT_EQ(RdlcTestRecords,payloads) << "rdlc: flags " << flags;
+        vRdlcDestroy(txHandle);
+        vRdlcDestroy(rxHandle);
+    }
+}
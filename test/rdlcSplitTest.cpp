@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief ֶνղԣжϲֻ֡У鲢ִлص
+**/
+
+TEST(RdlcTestSplit, Basic)
+{
+    const uint16_t msgMaxSize = 32;
+    Rdlc_t handle = RdlcTestCreate(msgMaxSize);
+    ASSERT_NE(handle,nullptr);
+    static uint8_t slots[4][RDLC_SPLIT_SLOT_SIZE(msgMaxSize)];
+    RdlcSplitRxConfig_t config = {&slots[0][0],sizeof(slots[0]),3};
+    RdlcSplitRx_t split;
+    EXPECT_EQ(xRdlcSplitRxInit(handle,&split,&config),RDLC_ERR_INVALID_ARG);
+    config.slotCount = 4;
+    ASSERT_EQ(xRdlcSplitRxInit(handle,&split,&config),RDLC_OK);
+    EXPECT_EQ(xRdlcSplitRxPoll(&split),RDLC_NOT_FINISH);
+
+    std::vector<uint8_t> a = {0x11,0xFF,0x22,0xFF,0xFF};
+    std::vector<uint8_t> b = {0x33,0x44};
+    std::vector<uint8_t> frameA = RdlcTestEncode(handle,a);
+    std::vector<uint8_t> frameB = RdlcTestEncode(handle,b);
+
+    //  + ֡A + CRC֡B + ֡B
+    std::vector<uint8_t> stream = {0x00,0x5A,0xC0};
+    stream.insert(stream.end(),frameA.begin(),frameA.end());
+    std::vector<uint8_t> bad = frameB;
+    bad[6] ^= 0x01;
+    stream.insert(stream.end(),bad.begin(),bad.end());
+    stream.insert(stream.end(),frameB.begin(),frameB.end());
+    RdlcTestRecords.clear();
+    EXPECT_EQ(xRdlcSplitRxIsrBytes(&split,stream.data(),stream.size()),RDLC_OK);
+    EXPECT_TRUE(RdlcTestRecords.empty()) << "rdlc: callbacks must not run on the ISR side";
+    EXPECT_EQ(xRdlcSplitRxPoll(&split),RDLC_ERR_CRC);
+    ASSERT_EQ(RdlcTestRecords.size(),2u);
+    EXPECT_EQ(RdlcTestRecords[0],a);
+    EXPECT_EQ(RdlcTestRecords[1],b);
+
+    // ֡ڳ֡ͷضϵ֡µ֡ͷʼ
+    RdlcTestRecords.clear();
+    std::vector<uint8_t> cut(frameA.begin(),frameA.begin() + 5);
+    cut.insert(cut.end(),frameB.begin(),frameB.end());
+    EXPECT_EQ(xRdlcSplitRxIsrBytes(&split,cut.data(),cut.size()),RDLC_OK);
+    EXPECT_EQ(xRdlcSplitRxPoll(&split),RDLC_OK);
+    ASSERT_EQ(RdlcTestRecords.size(),1u);
+    EXPECT_EQ(RdlcTestRecords[0],b);
+
+    // ͳ֡
+    RdlcTestRecords.clear();
+    for (int i = 0; i < 4; i++)
+        EXPECT_EQ(xRdlcSplitRxIsrBytes(&split,frameB.data(),frameB.size()),RDLC_OK);
+    EXPECT_EQ(xRdlcSplitRxIsrBytes(&split,frameB.data(),frameB.size()),RDLC_ERR_BUFFER_TOO_SHORT);
+    EXPECT_EQ(split.dropped,1u);
+    EXPECT_EQ(xRdlcSplitRxPoll(&split),RDLC_OK);
+    EXPECT_EQ(RdlcTestRecords.size(),4u);
+    Rdlc_t bigHandle = RdlcTestCreate(64);
+    std::vector<uint8_t> big(msgMaxSize + 1,0x55);
+    std::vector<uint8_t> frameBig = RdlcTestEncode(bigHandle,big);
+    EXPECT_EQ(xRdlcSplitRxIsrBytes(&split,frameBig.data(),frameBig.size()),RDLC_ERR_BUFFER_TOO_SHORT);
+    EXPECT_EQ(split.dropped,2u);
+    EXPECT_EQ(xRdlcSplitRxPoll(&split),RDLC_NOT_FINISH);
+
+    vRdlcDestroy(bigHandle);
+    vRdlcDestroy(handle);
+}
+
+TEST(RdlcTestSplit, IsrThread)
+{
+    // жֽ߳ڷ֡߳У鲢صж߳ڶʱȴⶪ֡
+    const uint16_t msgMaxSize = 200;
+    Rdlc_t txHandle = RdlcTestCreate(msgMaxSize);
+    Rdlc_t rxHandle = RdlcTestCreate(msgMaxSize);
+    static uint8_t slots[4][RDLC_SPLIT_SLOT_SIZE(msgMaxSize)];
+    RdlcSplitRxConfig_t config = {&slots[0][0],sizeof(slots[0]),4};
+    RdlcSplitRx_t split;
+    ASSERT_EQ(xRdlcSplitRxInit(rxHandle,&split,&config),RDLC_OK);
+
+    std::mt19937 rng(22);
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 3000; i++) {
+        std::vector<uint8_t> payload(1 + rng() % msgMaxSize);
+        for (auto &b : payload)
+            b = (rng() % 8 == 0) ? 0xFF : (uint8_t)rng();
+        frames.push_back(RdlcTestEncode(txHandle,payload));
+        payloads.push_back(payload);
+    }
+
+    RdlcTestRecords.clear();
+    std::atomic<bool> done(false);
+    int isrErrors = 0;
+    std::thread isr([&]() {
+        for (auto &frame : frames) {
+            while (split.head - __atomic_load_n(&split.tail,__ATOMIC_ACQUIRE) >= config.slotCount)
+                std::this_thread::yield();
+            for (uint8_t byte : frame) {
+                int res = xRdlcSplitRxIsrByte(&split,byte);
+                isrErrors += (res != RDLC_OK && res != RDLC_NOT_FINISH);
+            }
+        }
+        done.store(true,std::memory_order_release);
+    });
+    while (!done.load(std::memory_order_acquire)) {
+        EXPECT_THAT(xRdlcSplitRxPoll(&split),::testing::AnyOf(RDLC_OK,RDLC_NOT_FINISH));
+        std::this_thread::yield();
+    }
+    isr.join();
+    xRdlcSplitRxPoll(&split);
+
+    EXPECT_EQ(isrErrors,0);
+    EXPECT_EQ(split.dropped,0u);
+    EXPECT_EQ(RdlcTestRecords,payloads);
+    vRdlcDestroy(txHandle);
+    vRdlcDestroy(rxHandle);
+}
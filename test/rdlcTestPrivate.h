@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <cstring>
+#include <vector>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -27,5 +28,69 @@ MATCHER_P2(AddrEq, expectedSrc, expectedDst, "") {
     return arg.srcAddr == expectedSrc && arg.dstAddr == expectedDst;
 }
 
+/**
+ *@brief оߣRdlcTestOnParsed˳¼յغɺĿĵַʹǰ
+**/
+inline std::vector<std::vector<uint8_t>> RdlcTestRecords;
+inline std::vector<uint8_t> RdlcTestDstAddrs;
+
+inline int RdlcTestOnParsed(Rdlc_t handle,RdlcAddr_t addr,const uint8_t* data,uint16_t size)
+{
+    RdlcTestRecords.push_back(std::vector<uint8_t>(data,data+size));
+    RdlcTestDstAddrs.push_back(addr.dstAddr);
+    return 0;
+}
+
+/**
+ *@brief ʹmalloc/freeĽӿ
+**/
+inline RdlcPort_t RdlcTestPort(void)
+{
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    return port;
+}
+
+/**
+ *@brief Ĭãת޵msgMaxSizeصΪRdlcTestOnParsedԱٸ
+**/
+inline RdlcConfig_t RdlcTestConfig(uint32_t msgMaxSize,uint16_t flags = 0)
+{
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = RdlcTestOnParsed,
+        .cbError = NULL,
+        .flags = flags,
+    };
+    return config;
+}
+
+inline Rdlc_t RdlcTestCreate(const RdlcConfig_t &config)
+{
+    RdlcPort_t port = RdlcTestPort();
+    return xRdlcCreate(&config,&port);
+}
+
+inline Rdlc_t RdlcTestCreate(uint32_t msgMaxSize,uint16_t flags = 0)
+{
+    return RdlcTestCreate(RdlcTestConfig(msgMaxSize,flags));
+}
+
+/**
+ *@brief һ֡ϵȫֽ
+**/
+inline std::vector<uint8_t> RdlcTestEncode(Rdlc_t handle,const std::vector<uint8_t> &payload,RdlcAddr_t addr = {0x01,0x02})
+{
+    std::vector<uint8_t> frame(RDLC_GET_FRAME_SIZE(payload.size(),payload.size()));
+    int len = xRdlcWriteBytes(handle,addr,payload.data(),payload.size(),frame.data(),frame.size());
+    EXPECT_GT(len,0) << "rdlc: encode failed";
+    frame.resize(len > 0 ? len : 0);
+    return frame;
+}
+
 
 #endif // RDLCTESTPRIVATE_H_INCLUDED
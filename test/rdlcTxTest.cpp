@@ -0,0 +1,729 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "rdlc.h"
+#include "rdlcTestPrivate.h"
+
+/**
+ *@brief οʵֽ֣ת
+**/
+static void RdlcTxReferencePush(std::vector<uint8_t> &frame,uint8_t byte)
+{
+    if (byte == 0xFF)
+        frame.push_back(0xFF);
+    frame.push_back(byte);
+}
+
+static std::vector<uint8_t> RdlcTxReference(RdlcAddr_t addr,const uint8_t *payload,uint16_t size)
+{
+    uint16_t crc = RDLC_CRC16_INIT_VALUE;
+    for (uint16_t i = 0; i < size; i++) {
+        crc ^= payload[i];
+        for (int j = 0; j < 8; ++j)
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ 0xA001) : (crc >> 1);
+    }
+
+    std::vector<uint8_t> frame = {0xFF,0xC0};
+    RdlcTxReferencePush(frame,addr.srcAddr);
+    RdlcTxReferencePush(frame,addr.dstAddr);
+    RdlcTxReferencePush(frame,size & 0xFF);
+    RdlcTxReferencePush(frame,size >> 8);
+    for (uint16_t i = 0; i < size; i++)
+        RdlcTxReferencePush(frame,payload[i]);
+    RdlcTxReferencePush(frame,crc & 0xFF);
+    RdlcTxReferencePush(frame,crc >> 8);
+    frame.push_back(0xFF);
+    frame.push_back(0x0C);
+    return frame;
+}
+
+//========================================================================================
+
+/**
+ *@brief 1ⳤȡתܶ£οʵֽһ
+**/
+TEST(RdlcTestTx, MatchesReference)
+{
+    const uint16_t msgMaxSize = 3000;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::mt19937 rng(0x0C0C);
+    std::vector<uint8_t> payload(msgMaxSize);
+    std::vector<uint8_t> txBuf(RDLC_GET_FRAME_SIZE(msgMaxSize,msgMaxSize));
+    const int escapePercent[] = {0,2,50,100};
+
+    for (int percent : escapePercent) {
+        for (int round = 0; round < 300; round++) {
+            uint16_t size = (round < 100) ? round : rng() % (msgMaxSize + 1);
+            for (uint16_t i = 0; i < size; i++)
+                payload[i] = ((int)(rng() % 100) < percent) ? 0xFF : (rng() % 255);
+            RdlcAddr_t addr = {.srcAddr = (uint8_t)rng(), .dstAddr = (uint8_t)rng()};
+
+            int len = xRdlcWriteBytes(handle,addr,payload.data(),size,txBuf.data(),txBuf.size());
+            std::vector<uint8_t> expected = RdlcTxReference(addr,payload.data(),size);
+            ASSERT_EQ(len,(int)expected.size()) << "rdlc: frame length, size=" << size << ",percent=" << percent;
+            ASSERT_TRUE(std::equal(expected.begin(),expected.end(),txBuf.begin())) << "rdlc: frame content, size=" << size << ",percent=" << percent;
+        }
+    }
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 2תַ255ʱȷmsgMaxEscapeSizeʱҲԽ
+**/
+TEST(RdlcTestTx, ManyEscapes)
+{
+    const uint16_t msgMaxSize = 600;
+    const RdlcAddr_t expectAddr = {.srcAddr = 0x01, .dstAddr = 0x02};
+    std::vector<uint8_t> payload(msgMaxSize,0xFF);
+
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::vector<uint8_t> txBuf(RDLC_GET_FRAME_SIZE(msgMaxSize,msgMaxSize));
+    int len = xRdlcWriteBytes(handle,expectAddr,payload.data(),msgMaxSize,txBuf.data(),txBuf.size());
+    std::vector<uint8_t> expected = RdlcTxReference(expectAddr,payload.data(),msgMaxSize);
+    ASSERT_EQ(len,(int)expected.size()) << "rdlc: frame length";
+    EXPECT_TRUE(std::equal(expected.begin(),expected.end(),txBuf.begin())) << "rdlc: frame content";
+    vRdlcDestroy(handle);
+
+    // ֻԤ300תַʱ뱨Ҳд
+    config.msgMaxEscapeSize = 300;
+    handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+    size_t frameSize = RDLC_GET_FRAME_SIZE(msgMaxSize,300);
+    std::vector<uint8_t> guarded(frameSize + 16,0xA5);
+    EXPECT_EQ(xRdlcWriteBytes(handle,expectAddr,payload.data(),msgMaxSize,guarded.data(),frameSize),RDLC_ERR_BUFFER_TOO_SHORT);
+    for (size_t i = frameSize; i < guarded.size(); i++)
+        ASSERT_EQ(guarded[i],0xA5) << "rdlc: tx buffer overflow at " << i;
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 3xRdlcGetFrameSizeȷȣǡôĻܷһֽ򱨴ҲԽ
+**/
+TEST(RdlcTestTx, ExactFrameSize)
+{
+    const uint16_t msgMaxSize = 1000;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::mt19937 rng(0xC0FF);
+    std::vector<uint8_t> payload(msgMaxSize);
+    const int escapePercent[] = {0,2,50,100};
+
+    for (int percent : escapePercent) {
+        for (int round = 0; round < 300; round++) {
+            uint16_t size = (round < 2) ? 255 * (round + 1) : rng() % (msgMaxSize + 1);
+            for (uint16_t i = 0; i < size; i++)
+                payload[i] = ((int)(rng() % 100) < percent) ? 0xFF : (rng() % 255);
+            RdlcAddr_t addr = {.srcAddr = (uint8_t)((round % 3) ? rng() : 0xFF), .dstAddr = (uint8_t)rng()};
+            std::vector<uint8_t> expected = RdlcTxReference(addr,payload.data(),size);
+
+            int exact = xRdlcGetFrameSize(handle,addr,payload.data(),size);
+            ASSERT_EQ(exact,(int)expected.size()) << "rdlc: exact size, size=" << size << ",percent=" << percent;
+
+            std::vector<uint8_t> guarded(exact + 16,0xA5);
+            ASSERT_EQ(xRdlcWriteBytes(handle,addr,payload.data(),size,guarded.data(),exact),exact) << "rdlc: write into exact buffer";
+            ASSERT_TRUE(std::equal(expected.begin(),expected.end(),guarded.begin())) << "rdlc: frame content";
+
+            std::fill(guarded.begin(),guarded.end(),0xA5);
+            ASSERT_EQ(xRdlcWriteBytes(handle,addr,payload.data(),size,guarded.data(),exact - 1),RDLC_ERR_BUFFER_TOO_SHORT);
+            for (size_t i = exact - 1; i < guarded.size(); i++)
+                ASSERT_EQ(guarded[i],0xA5) << "rdlc: tx buffer overflow at " << i;
+        }
+    }
+
+    EXPECT_EQ(xRdlcGetFrameSize(handle,{0x01,0x02},payload.data(),msgMaxSize + 1),RDLC_ERR_INVALID_ARG);
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 4غɷƴӺٷȫһ
+**/
+TEST(RdlcTestTx, Fragments)
+{
+    const uint16_t msgMaxSize = 1000;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::mt19937 rng(0xF4A6);
+    std::vector<uint8_t> payload(msgMaxSize);
+    std::vector<uint8_t> txBuf(RDLC_GET_FRAME_SIZE(msgMaxSize,msgMaxSize));
+    const RdlcAddr_t expectAddr = {.srcAddr = 0x01, .dstAddr = 0x02};
+
+    for (int round = 0; round < 500; round++) {
+        uint16_t size = rng() % (msgMaxSize + 1);
+        for (uint16_t i = 0; i < size; i++)
+            payload[i] = (rng() % 8 == 0) ? 0xFF : (rng() % 255);
+
+        // гɶΣΪ0Ķ
+        std::vector<RdlcFragment_t> fragments;
+        uint16_t pos = 0;
+        while (pos < size || fragments.empty()) {
+            uint16_t len = rng() % (size - pos + 1);
+            fragments.push_back({len ? &payload[pos] : NULL,len});
+            pos += len;
+        }
+
+        std::vector<uint8_t> expected = RdlcTxReference(expectAddr,payload.data(),size);
+        int len = xRdlcWriteFragments(handle,expectAddr,fragments.data(),fragments.size(),txBuf.data(),txBuf.size());
+        ASSERT_EQ(len,(int)expected.size()) << "rdlc: frame length, size=" << size << ",fragments=" << fragments.size();
+        ASSERT_TRUE(std::equal(expected.begin(),expected.end(),txBuf.begin())) << "rdlc: frame content";
+    }
+
+    // Ƭγ֮ͳmsgMaxSize
+    RdlcFragment_t tooLong[2] = {{payload.data(),msgMaxSize},{payload.data(),1}};
+    EXPECT_EQ(xRdlcWriteFragments(handle,expectAddr,tooLong,2,txBuf.data(),txBuf.size()),RDLC_ERR_BUFFER_TOO_SHORT);
+    RdlcFragment_t nullData = {NULL,1};
+    EXPECT_EQ(xRdlcWriteFragments(handle,expectAddr,&nullData,1,txBuf.data(),txBuf.size()),RDLC_ERR_INVALID_ARG);
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 5㿽ƬƴƬμΪ֡תغֱpayload
+**/
+TEST(RdlcTestTx, Iovec)
+{
+    const uint16_t msgMaxSize = 1000;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::mt19937 rng(0x10CE);
+    std::vector<uint8_t> payload(msgMaxSize);
+    std::vector<RdlcFragment_t> iov(msgMaxSize + 3);
+    uint8_t scratch[RDLC_IOV_SCRATCH_SIZE];
+    const int escapePercent[] = {0,2,50,100};
+
+    for (int percent : escapePercent) {
+        for (int round = 0; round < 300; round++) {
+            uint16_t size = (round < 20) ? round : rng() % (msgMaxSize + 1);
+            size_t escapes = 0;
+            for (uint16_t i = 0; i < size; i++) {
+                payload[i] = ((int)(rng() % 100) < percent) ? 0xFF : (rng() % 255);
+                escapes += (payload[i] == 0xFF);
+            }
+            RdlcAddr_t addr = {.srcAddr = (uint8_t)rng(), .dstAddr = (uint8_t)rng()};
+
+            int count = xRdlcWriteIovec(handle,addr,payload.data(),size,iov.data(),iov.size(),scratch,sizeof(scratch));
+            ASSERT_EQ(count,(int)(escapes + (size ? 3 : 2))) << "rdlc: iov count, size=" << size << ",percent=" << percent;
+
+            std::vector<uint8_t> frame;
+            size_t referenced = 0;
+            for (int i = 0; i < count; i++) {
+                frame.insert(frame.end(),iov[i].data,iov[i].data + iov[i].size);
+                if (iov[i].data >= payload.data() && iov[i].data < payload.data() + size)
+                    referenced += iov[i].size;
+            }
+            ASSERT_EQ(frame,RdlcTxReference(addr,payload.data(),size)) << "rdlc: frame content, size=" << size << ",percent=" << percent;
+            EXPECT_EQ(referenced,size + escapes) << "rdlc: payload was copied";
+        }
+    }
+
+    // Ƭݴ
+    std::fill(payload.begin(),payload.begin() + 10,0xFF);
+    EXPECT_EQ(xRdlcWriteIovec(handle,{0x01,0x02},payload.data(),10,iov.data(),12,scratch,sizeof(scratch)),RDLC_ERR_BUFFER_TOO_SHORT);
+    EXPECT_EQ(xRdlcWriteIovec(handle,{0xFF,0xFF},payload.data(),10,iov.data(),13,scratch,8),RDLC_ERR_BUFFER_TOO_SHORT);
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 6ԭط֡ͷдԤͷռУغɾ͵ת壬οʵһ
+**/
+TEST(RdlcTestTx, InPlace)
+{
+    const uint16_t msgMaxSize = 3000;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::mt19937 rng(0x1EAF);
+    std::vector<uint8_t> payload(msgMaxSize);
+    std::vector<uint8_t> buffer(RDLC_INPLACE_HEADROOM + msgMaxSize + RDLC_INPLACE_TAILROOM(msgMaxSize));
+    const int escapePercent[] = {0,2,50,100};
+
+    for (int percent : escapePercent) {
+        for (int round = 0; round < 300; round++) {
+            uint16_t size = (round < 100) ? round : rng() % (msgMaxSize + 1);
+            for (uint16_t i = 0; i < size; i++)
+                payload[i] = ((int)(rng() % 100) < percent) ? 0xFF : (rng() % 255);
+            RdlcAddr_t addr = {.srcAddr = (uint8_t)rng(), .dstAddr = (uint8_t)rng()};
+            uint16_t headroom = RDLC_INPLACE_HEADROOM + rng() % 4;
+            std::copy(payload.begin(),payload.begin() + size,buffer.begin() + headroom);
+
+            uint8_t *frame = NULL;
+            int len = xRdlcWriteInPlace(handle,addr,buffer.data(),buffer.size(),headroom,size,&frame);
+            std::vector<uint8_t> expected = RdlcTxReference(addr,payload.data(),size);
+            ASSERT_EQ(len,(int)expected.size()) << "rdlc: frame size, size=" << size << ",percent=" << percent;
+            ASSERT_GE(frame,buffer.data());
+            ASSERT_LE(frame + len,buffer.data() + buffer.size());
+            ASSERT_EQ(std::vector<uint8_t>(frame,frame + len),expected) << "rdlc: frame content, size=" << size << ",percent=" << percent;
+        }
+    }
+
+    // ͷβԤʱغɱֲ
+    RdlcAddr_t addr = {.srcAddr = 0xFF, .dstAddr = 0xFF};
+    std::fill(payload.begin(),payload.begin() + 10,0xFF);
+    std::vector<uint8_t> expected = RdlcTxReference(addr,payload.data(),10);
+    std::vector<uint8_t> small(expected.size());// ֡ͷFF C0 FF FF FF FF 0A 008ֽ
+    uint8_t *frame = NULL;
+    std::copy(payload.begin(),payload.begin() + 10,small.begin() + 7);
+    EXPECT_EQ(xRdlcWriteInPlace(handle,addr,small.data(),small.size(),7,10,&frame),RDLC_ERR_BUFFER_TOO_SHORT);
+    EXPECT_TRUE(std::equal(payload.begin(),payload.begin() + 10,small.begin() + 7));
+    std::copy(payload.begin(),payload.begin() + 10,small.begin() + 8);
+    EXPECT_EQ(xRdlcWriteInPlace(handle,addr,small.data(),small.size() - 1,8,10,&frame),RDLC_ERR_BUFFER_TOO_SHORT);
+    EXPECT_TRUE(std::equal(payload.begin(),payload.begin() + 10,small.begin() + 8));
+    EXPECT_EQ(xRdlcWriteInPlace(handle,addr,small.data(),small.size(),8,10,&frame),(int)expected.size());
+    EXPECT_EQ(frame,small.data());
+    EXPECT_EQ(small,expected);
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 7ʽСȡƴӺһԷȫһ
+**/
+TEST(RdlcTestTx, StreamEncoder)
+{
+    const uint16_t msgMaxSize = 3000;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    std::mt19937 rng(0x5EAB);
+    std::vector<uint8_t> payload(msgMaxSize);
+    const int escapePercent[] = {0,2,50,100};
+
+    for (int percent : escapePercent) {
+        for (int round = 0; round < 200; round++) {
+            uint16_t size = (round < 10) ? round : rng() % (msgMaxSize + 1);
+            for (uint16_t i = 0; i < size; i++)
+                payload[i] = ((int)(rng() % 100) < percent) ? 0xFF : (rng() % 255);
+            RdlcAddr_t addr = {.srcAddr = (uint8_t)rng(), .dstAddr = (uint8_t)rng()};
+            uint16_t chunkMax = (round % 4 == 0) ? 1 : (1 + rng() % 300);
+
+            RdlcEncoder_t encoder;
+            ASSERT_EQ(xRdlcEncoderInit(handle,&encoder,addr,payload.data(),size),RDLC_OK);
+            std::vector<uint8_t> frame;
+            uint8_t chunk[300];
+            int len;
+            while ((len = xRdlcEncoderPull(&encoder,chunk,1 + rng() % chunkMax)) > 0)
+                frame.insert(frame.end(),chunk,chunk + len);
+            ASSERT_EQ(len,0) << "rdlc: pull failed";
+            ASSERT_EQ(frame,RdlcTxReference(addr,payload.data(),size)) << "rdlc: frame content, size=" << size << ",percent=" << percent;
+            EXPECT_EQ(xRdlcEncoderPull(&encoder,chunk,sizeof(chunk)),0) << "rdlc: pull after done";
+        }
+    }
+
+    RdlcEncoder_t encoder;
+    EXPECT_EQ(xRdlcEncoderInit(handle,&encoder,{0x01,0x02},payload.data(),msgMaxSize + 1),RDLC_ERR_BUFFER_TOO_SHORT);
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 8ĸƴ֡һ£ƫָÿһ֡㣬Ⱥʱ
+**/
+struct RdlcBatchRecord_t
+{
+    std::vector<uint8_t> data;
+    std::vector<uint16_t> offsets;
+};
+static std::vector<RdlcBatchRecord_t> BatchRecords;
+static int BatchFlushResult = RDLC_OK;
+
+extern "C" int RdlcTestBatchFlush(Rdlc_t handle,const uint8_t *data,uint16_t size,const uint16_t *offsets,uint16_t count)
+{
+    if (BatchFlushResult != RDLC_OK)
+        return BatchFlushResult;
+    RdlcBatchRecord_t record;
+    record.data.assign(data,data + size);
+    if (offsets != NULL)
+        record.offsets.assign(offsets,offsets + count);
+    BatchRecords.push_back(record);
+    return RDLC_OK;
+}
+
+TEST(RdlcTestTx, Batch)
+{
+    const uint16_t msgMaxSize = 100;
+    RdlcConfig_t config = {
+        .msgMaxSize = msgMaxSize,
+        .msgMaxEscapeSize = msgMaxSize,
+        .cbParsed = NULL,
+        .cbError = NULL,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    static uint8_t batchBuf[512];
+    static uint16_t batchOffsets[16];
+    RdlcBatchConfig_t batchConfig = {
+        .buffer = batchBuf,
+        .bufferSize = sizeof(batchBuf),
+        .offsets = batchOffsets,
+        .offsetsMax = 16,
+        .flushSize = 400,
+        .flushTicks = 0,
+        .cbFlush = RdlcTestBatchFlush,
+    };
+    RdlcBatch_t batch;
+    ASSERT_EQ(xRdlcBatchInit(handle,&batch,&batchConfig),RDLC_OK);
+
+    std::mt19937 rng(0xBA7C);
+    std::vector<std::vector<uint8_t>> expected;
+    BatchRecords.clear();
+    for (int i = 0; i < 1000; i++) {
+        std::vector<uint8_t> payload(1 + rng() % msgMaxSize);
+        for (auto &b : payload)
+            b = (rng() % 16 == 0) ? 0xFF : (rng() % 255);
+        RdlcAddr_t addr = {.srcAddr = (uint8_t)rng(), .dstAddr = (uint8_t)rng()};
+        expected.push_back(RdlcTxReference(addr,payload.data(),payload.size()));
+        ASSERT_GE(xRdlcBatchAppend(&batch,addr,payload.data(),payload.size(),0),0) << "rdlc: append failed";
+    }
+    ASSERT_EQ(xRdlcBatchFlush(&batch),RDLC_OK);
+
+    // ÿһƫ飬ƫƴǶӦ֡
+    size_t frame = 0;
+    for (auto &record : BatchRecords) {
+        ASSERT_LE(record.data.size(),sizeof(batchBuf));
+        ASSERT_LE(record.offsets.size(),16u);
+        ASSERT_FALSE(record.offsets.empty());
+        for (size_t i = 0; i < record.offsets.size(); i++, frame++) {
+            size_t end = (i + 1 < record.offsets.size()) ? record.offsets[i + 1] : record.data.size();
+            std::vector<uint8_t> got(record.data.begin() + record.offsets[i],record.data.begin() + end);
+            ASSERT_EQ(got,expected[frame]) << "rdlc: frame " << frame;
+        }
+    }
+    EXPECT_EQ(frame,expected.size()) << "rdlc: frame lost";
+    EXPECT_LT(BatchRecords.size(),expected.size() / 4) << "rdlc: frames not coalesced";
+
+    // ʱʱ
+    batchConfig.flushSize = 0;
+    batchConfig.flushTicks = 10;
+    ASSERT_EQ(xRdlcBatchInit(handle,&batch,&batchConfig),RDLC_OK);
+    BatchRecords.clear();
+    const uint8_t small[] = {0x11,0x22,0x33};
+    uint32_t start = 0xFFFFFFF8u;
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),start),0);
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),start + 5),1);
+    EXPECT_EQ(xRdlcBatchPoll(&batch,start + 9),RDLC_OK);
+    EXPECT_TRUE(BatchRecords.empty()) << "rdlc: flushed too early";
+    EXPECT_EQ(xRdlcBatchPoll(&batch,start + 10),RDLC_OK);
+    ASSERT_EQ(BatchRecords.size(),1u) << "rdlc: not flushed on time";
+    EXPECT_EQ(BatchRecords[0].offsets.size(),2u);
+
+    // ʧʱcbFlushĴţﵽflushSizeƫŲ
+    batchConfig.flushSize = 1;
+    batchConfig.flushTicks = 0;
+    ASSERT_EQ(xRdlcBatchInit(handle,&batch,&batchConfig),RDLC_OK);
+    BatchFlushResult = RDLC_ERR_IO;
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),RDLC_ERR_IO);
+    BatchFlushResult = RDLC_OK;
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),0);
+
+    batchConfig.flushSize = 0;
+    batchConfig.offsetsMax = 2;
+    ASSERT_EQ(xRdlcBatchInit(handle,&batch,&batchConfig),RDLC_OK);
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),0);
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),1);
+    BatchFlushResult = RDLC_ERR_IO;
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),RDLC_ERR_IO);
+    BatchFlushResult = RDLC_OK;
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),0) << "rdlc: frame queued after a failed flush";
+
+    batchConfig.offsets = NULL;
+    batchConfig.offsetsMax = 0;
+    uint8_t smallFrame[RDLC_GET_FRAME_SIZE(sizeof(small),sizeof(small))];
+    int smallLen = xRdlcWriteBytes(handle,{0x01,0x02},small,sizeof(small),smallFrame,sizeof(smallFrame));
+    ASSERT_GT(smallLen,0);
+    batchConfig.bufferSize = smallLen * 2;
+    ASSERT_EQ(xRdlcBatchInit(handle,&batch,&batchConfig),RDLC_OK);
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),0);
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),1);
+    BatchFlushResult = RDLC_ERR_IO;
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),RDLC_ERR_IO);
+    BatchFlushResult = RDLC_OK;
+    EXPECT_EQ(xRdlcBatchAppend(&batch,{0x01,0x02},small,sizeof(small),0),0) << "rdlc: frame queued after a failed flush";
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 9֡أȡպ󱨴黹ȡ̲߳ȡʱÿͬһʱֻһ߳
+**/
+TEST(RdlcTestTx, FramePool)
+{
+    const uint16_t poolCount = 4;
+    RdlcConfig_t config = {
+        .msgMaxSize = 100,
+        .msgMaxEscapeSize = 10,
+        .cbParsed = NULL,
+        .cbError = NULL,
+        .flags = 0,
+        .framePoolCount = poolCount,
+    };
+    RdlcPort_t port = {
+        .portMalloc = malloc,
+        .portFree = free,
+        .portPrintf = NULL,
+    };
+    Rdlc_t handle = xRdlcCreate(&config,&port);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+
+    uint8_t *frames[poolCount];
+    uint16_t size = 0;
+    for (uint16_t i = 0; i < poolCount; i++) {
+        ASSERT_EQ(xRdlcFrameCreate(handle,&frames[i],&size),RDLC_OK);
+        EXPECT_EQ(size,RDLC_GET_FRAME_SIZE(100,10));
+        EXPECT_EQ((uintptr_t)frames[i] % 8,0u) << "rdlc: frame not aligned";
+        memset(frames[i],i,size);
+        for (uint16_t j = 0; j < i; j++)
+            EXPECT_NE(frames[i],frames[j]);
+    }
+    uint8_t *extra = NULL;
+    EXPECT_EQ(xRdlcFrameCreate(handle,&extra,&size),RDLC_ERR_POOL_EMPTY);
+
+    vRdlcFrameDestroy(handle,frames[2]);
+    ASSERT_EQ(xRdlcFrameCreate(handle,&extra,&size),RDLC_OK);
+    EXPECT_EQ(extra,frames[2]);
+    EXPECT_EQ(extra[0],2) << "rdlc: frame from pool should not be cleared";
+
+    // ֱ֡ڷ
+    const uint8_t payload[] = {0x11,0xFF,0x22};
+    RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+    int len = xRdlcWriteBytes(handle,addr,payload,sizeof(payload),extra,size);
+    EXPECT_EQ(std::vector<uint8_t>(extra,extra + len),RdlcTxReference(addr,payload,sizeof(payload)));
+    for (uint16_t i = 0; i < poolCount; i++)
+        vRdlcFrameDestroy(handle,frames[i]);
+
+    // ȡ
+    const int threadCount = 4;
+    std::vector<int> errors(threadCount,0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([handle,t,&errors]() {
+            for (int round = 0; round < 100000; round++) {
+                uint8_t *frame = NULL;
+                uint16_t frameSize = 0;
+                int err = xRdlcFrameCreate(handle,&frame,&frameSize);
+                if (err == RDLC_ERR_POOL_EMPTY)
+                    continue;
+                if (err != RDLC_OK) {
+                    errors[t]++;
+                    continue;
+                }
+                memset(frame,t,frameSize);
+                for (uint16_t i = 0; i < frameSize; i++)
+                    errors[t] += (frame[i] != t);
+                vRdlcFrameDestroy(handle,frame);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    for (int t = 0; t < threadCount; t++)
+        EXPECT_EQ(errors[t],0) << "rdlc: frame shared between threads, thread=" << t;
+
+    // ȫ黹ȻȡpoolCount
+    for (uint16_t i = 0; i < poolCount; i++)
+        ASSERT_EQ(xRdlcFrameCreate(handle,&frames[i],&size),RDLC_OK);
+    EXPECT_EQ(xRdlcFrameCreate(handle,&extra,&size),RDLC_ERR_POOL_EMPTY);
+    vRdlcDestroy(handle);
+}
+
+//========================================================================================
+
+/**
+ *@brief 10Ϊ0غ(֡)ӿڵĽһ£ֽڡκ㿽նԳ0ص
+**/
+TEST(RdlcTestTx, EmptyPayload)
+{
+    Rdlc_t handle = RdlcTestCreate(64);
+    ASSERT_NE(handle, nullptr) << "rdlc: init handle failed";
+    const RdlcAddr_t addr = {.srcAddr = 0x01, .dstAddr = 0x02};
+    const uint8_t empty[1] = {0};
+    const std::vector<uint8_t> expected = RdlcTxReference(addr,empty,0);
+    std::vector<std::vector<uint8_t>> frames;
+
+    uint8_t frameBuf[RDLC_GET_FRAME_SIZE(0,0)];
+    EXPECT_EQ(xRdlcGetFrameSize(handle,addr,empty,0),(int)expected.size());
+    int len = xRdlcWriteBytes(handle,addr,empty,0,frameBuf,sizeof(frameBuf));
+    ASSERT_GT(len,0) << "rdlc: write bytes failed";
+    frames.push_back(std::vector<uint8_t>(frameBuf,frameBuf + len));
+
+    const RdlcFragment_t fragment = {.data = NULL, .size = 0};
+    len = xRdlcWriteFragments(handle,addr,&fragment,1,frameBuf,sizeof(frameBuf));
+    ASSERT_GT(len,0) << "rdlc: write fragments failed";
+    frames.push_back(std::vector<uint8_t>(frameBuf,frameBuf + len));
+
+    RdlcFragment_t iov[8];
+    uint8_t scratch[RDLC_IOV_SCRATCH_SIZE];
+    int count = xRdlcWriteIovec(handle,addr,empty,0,iov,8,scratch,sizeof(scratch));
+    ASSERT_GT(count,0) << "rdlc: write iovec failed";
+    std::vector<uint8_t> joined;
+    for (int i = 0; i < count; i++)
+        joined.insert(joined.end(),iov[i].data,iov[i].data + iov[i].size);
+    frames.push_back(joined);
+
+    uint8_t inPlace[RDLC_INPLACE_HEADROOM + RDLC_INPLACE_TAILROOM(0)];
+    uint8_t *frame = NULL;
+    len = xRdlcWriteInPlace(handle,addr,inPlace,sizeof(inPlace),RDLC_INPLACE_HEADROOM,0,&frame);
+    ASSERT_GT(len,0) << "rdlc: write in place failed";
+    frames.push_back(std::vector<uint8_t>(frame,frame + len));
+
+    RdlcEncoder_t encoder;
+    ASSERT_EQ(xRdlcEncoderInit(handle,&encoder,addr,empty,0),RDLC_OK);
+    joined.clear();
+    uint8_t chunk[3];
+    while ((len = xRdlcEncoderPull(&encoder,chunk,sizeof(chunk))) > 0)
+        joined.insert(joined.end(),chunk,chunk + len);
+    ASSERT_EQ(len,0) << "rdlc: pull failed";
+    frames.push_back(joined);
+
+    static uint8_t batchBuf[64];
+    static uint16_t batchOffsets[4];
+    RdlcBatchConfig_t batchConfig = {
+        .buffer = batchBuf,
+        .bufferSize = sizeof(batchBuf),
+        .offsets = batchOffsets,
+        .offsetsMax = 4,
+        .flushSize = 0,
+        .flushTicks = 0,
+        .cbFlush = RdlcTestBatchFlush,
+    };
+    RdlcBatch_t batch;
+    ASSERT_EQ(xRdlcBatchInit(handle,&batch,&batchConfig),RDLC_OK);
+    BatchRecords.clear();
+    ASSERT_EQ(xRdlcBatchAppend(&batch,addr,empty,0,0),0);
+    ASSERT_EQ(xRdlcBatchFlush(&batch),RDLC_OK);
+    ASSERT_EQ(BatchRecords.size(),1u);
+    frames.push_back(BatchRecords[0].data);
+    vRdlcDestroy(handle);
+
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < frames.size(); i++) {
+        EXPECT_EQ(frames[i],expected) << "rdlc: encoder " << i;
+        stream.insert(stream.end(),frames[i].begin(),frames[i].end());
+    }
+
+    // նˣÿһ֡Գ0ص
+    const uint16_t flagsList[] = {0,RDLC_FLAG_RX_ZERO_COPY};
+    for (uint16_t flags : flagsList) {
+        Rdlc_t rxHandle = RdlcTestCreate(64,flags);
+        ASSERT_NE(rxHandle, nullptr) << "rdlc: init handle failed";
+        RdlcTestRecords.clear();
+        RdlcTestDstAddrs.clear();
+        int res = RDLC_NOT_FINISH;
+        for (uint8_t byte : stream) {
+            int ret = xRdlcReadByte(rxHandle,byte);
+            if (ret != RDLC_NOT_FINISH)
+                res = ret;
+        }
+        EXPECT_EQ(res,RDLC_OK);
+        EXPECT_EQ(xRdlcReadBytes(rxHandle,stream.data(),stream.size()),RDLC_OK);
+        EXPECT_EQ(RdlcTestRecords,std::vector<std::vector<uint8_t>>(2 * frames.size())) << "rdlc: flags=" << flags;
+        EXPECT_EQ(RdlcTestDstAddrs,std::vector<uint8_t>(2 * frames.size(),addr.dstAddr));
+        vRdlcDestroy(rxHandle);
+    }
+}